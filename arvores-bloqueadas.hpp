@@ -0,0 +1,453 @@
+#ifndef DATA_STRUCTURES_LOCKED_TREE
+#define DATA_STRUCTURES_LOCKED_TREE
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arvores-gerais.hpp"
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *                 Locked Tree                  * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Locked Tree Class
+	 *   class Locked_tree<Tree>
+	 *
+	 * A wrapper around a general tree through which any
+	 * number of threads may insert and erase nodes at the
+	 * same time.  Writers in disjoint subtrees only contend
+	 * on the ancestors they share when their heights change.
+	 *
+	 * The nodes are protected by a fixed number of mutexes
+	 * (stripes) chosen by hashing the address of the node,
+	 * and a thread never holds more than one stripe, so
+	 * writers cannot deadlock.  The stripe of a node protects
+	 * its list of children and its height:
+	 *  - insert() and erase() link or unlink the child while
+	 *    holding the stripe of the parent and record the
+	 *    change of size in that stripe,
+	 *  - the heights are then updated one ancestor at a time:
+	 *    the stripe of each ancestor in turn is held while its
+	 *    height is raised (by insert) or recomputed from its
+	 *    children (by erase), stopping at the first which is
+	 *    unchanged.
+	 * Since the height of a child is always written before
+	 * the stripe of its parent is taken, an ancestor is never
+	 * left lower than any of its children.
+	 *
+	 * The recorded changes of size are applied to the
+	 * ancestors in batches, so that writers do not all modify
+	 * the size of the root and of the other nodes near it:
+	 * once a stripe holds pending_limit changes, the writer
+	 * sums them for each ancestor and adds each sum with one
+	 * atomic operation, and flush() (also called when the
+	 * wrapper is destroyed) applies all remaining changes.
+	 * The sizes stored in the tree therefore lag behind by
+	 * at most pending_limit changes per stripe until flush().
+	 * The erased subtrees are only deleted by flush(), so
+	 * their memory is held until then.
+	 *
+	 * The tree must store the degree, height and size and
+	 * neither a hash nor a subtree aggregate, which would
+	 * have to be recomputed along the whole path.
+	 *
+	 * Until flush() is called, the tree may only be read
+	 * through size() and height() of the wrapper, and a node
+	 * may not be erased while another thread inserts within
+	 * or erases its subtree.
+	 ****************************************************/
+
+	template <typename Tree>
+	class Locked_tree {
+		public:
+			typedef typename Tree::iterator iterator;
+
+			explicit Locked_tree( Tree &, int stripes = 64 );
+			~Locked_tree();
+
+			int size() const;
+			int height() const;
+
+			iterator insert( iterator parent, typename Tree::iterator::value_type const &obj );
+			int erase( iterator itr );
+			void flush();
+
+		private:
+			typedef typename Tree::tree_node tree_node;
+			typedef typename Tree::metadata_type metadata_type;
+
+			typedef std::vector<std::pair<tree_node *, int> > change_list;
+
+			static std::size_t const pending_limit = 1024;
+			static std::size_t const line_size = 64;
+
+			// Each stripe occupies its own cache lines:  the count
+			// is the change of the size of the tree and each entry
+			// of pending is a change of the size of a node and of
+			// its ancestors, both not yet applied
+			struct alignas( 64 ) stripe {
+				std::mutex lock;
+				int count;
+				change_list pending;
+				std::vector<tree_node *> retired;
+
+				stripe(): count( 0 ) {}
+			};
+
+			Tree *tree;
+			void *storage;
+			stripe *stripes;
+			std::size_t stripe_count;
+
+			stripe &stripe_of( tree_node const * ) const;
+			void record( stripe &, tree_node *, int, change_list & );
+			void apply( stripe &, change_list & );
+
+			Locked_tree( Locked_tree const & );
+			Locked_tree &operator=( Locked_tree const & );
+	};
+
+	/*
+	 * Constructor
+	 *   Locked_tree<Tree> :: Locked_tree( Tree &t, int stripes )
+	 *
+	 * Creates a wrapper around the tree with the given
+	 * number of mutexes.  The stripes are constructed in a
+	 * block aligned by hand to a cache line, as the allocator
+	 * of a vector need not respect the alignment of a stripe
+	 * before C++17.
+	 *
+	 * O(stripes)
+	 */
+
+	template <typename Tree>
+	Locked_tree<Tree>::Locked_tree( Tree &t, int n ):
+	tree( &t ),
+	storage( 0 ),
+	stripes( 0 ),
+	stripe_count( n < 1 ? 1 : n ) {
+		static_assert( metadata_type::degree && metadata_type::height && metadata_type::size,
+		               "Locked_tree requires the degree, height and size to be stored" );
+		static_assert( !metadata_type::hash && !tree_node::aggregated,
+		               "Locked_tree does not maintain hashes or subtree aggregates" );
+		static_assert( sizeof( stripe ) % line_size == 0, "a stripe must fill whole cache lines" );
+
+		storage = ::operator new( stripe_count*sizeof( stripe ) + line_size - 1 );
+
+		uintptr_t address = reinterpret_cast<uintptr_t>( storage );
+		stripes = reinterpret_cast<stripe *>( ( address + line_size - 1 )/line_size*line_size );
+
+		for ( std::size_t k = 0; k < stripe_count; ++k ) {
+			new ( stripes + k ) stripe();
+		}
+	}
+
+	/*
+	 * Destructor
+	 *   Locked_tree<Tree> :: ~Locked_tree()
+	 *
+	 * Applies the recorded changes of size to the tree and
+	 * destroys the stripes.
+	 *
+	 * O(flush)
+	 */
+
+	template <typename Tree>
+	Locked_tree<Tree>::~Locked_tree() {
+		flush();
+
+		for ( std::size_t k = 0; k < stripe_count; ++k ) {
+			stripes[k].~stripe();
+		}
+
+		::operator delete( storage );
+	}
+
+	/*
+	 * Size
+	 *   int Locked_tree<Tree> :: size() const
+	 *
+	 * Returns the size of the root together with the changes
+	 * recorded in each stripe.  While a batch is applied, the
+	 * result may be off by the size of the batch.
+	 *
+	 * O(stripes)
+	 */
+
+	template <typename Tree>
+	int Locked_tree<Tree>::size() const {
+		int result = __atomic_load_n( &tree->root_node->node_size, __ATOMIC_RELAXED );
+
+		for ( std::size_t k = 0; k < stripe_count; ++k ) {
+			result += __atomic_load_n( &stripes[k].count, __ATOMIC_RELAXED );
+		}
+
+		return result;
+	}
+
+	template <typename Tree>
+	int Locked_tree<Tree>::height() const {
+		return __atomic_load_n( &tree->root_node->node_height, __ATOMIC_RELAXED );
+	}
+
+	/*
+	 * Insert
+	 *   iterator Locked_tree<Tree> :: insert( iterator parent, Type const &obj )
+	 *
+	 * Appends a new child storing the object to the node
+	 * referred to by parent and returns an iterator referring
+	 * to it.
+	 *
+	 * O(depth) for the heights, holding one stripe at a time,
+	 * plus applying a batch of changes of size once every
+	 * pending_limit changes recorded in the stripe
+	 */
+
+	template <typename Tree>
+	typename Locked_tree<Tree>::iterator Locked_tree<Tree>::insert( iterator parent, typename Tree::iterator::value_type const &obj ) {
+		tree_node *par = parent.current_node;
+		tree_node *child = new tree_node( obj, par, 0, 0, metadata_type::depth ? par->depth() + 1 : 0 );
+		stripe &s = stripe_of( par );
+		change_list batch;
+
+		{
+			std::lock_guard<std::mutex> guard( s.lock );
+
+			par->append_child( child );
+			__atomic_store_n( &par->node_degree, par->node_degree + 1, __ATOMIC_RELAXED );
+			record( s, par, 1, batch );
+		}
+
+		apply( s, batch );
+
+		for ( tree_node *current = child, *regress = par; regress != 0; current = regress, regress = regress->parent ) {
+			std::lock_guard<std::mutex> guard( stripe_of( regress ).lock );
+
+			int h = __atomic_load_n( &current->node_height, __ATOMIC_RELAXED ) + 1;
+
+			if ( h <= regress->node_height ) {
+				break;
+			}
+
+			__atomic_store_n( &regress->node_height, h, __ATOMIC_RELAXED );
+		}
+
+		return iterator( child, par );
+	}
+
+	/*
+	 * Erase
+	 *   int Locked_tree<Tree> :: erase( iterator itr )
+	 *
+	 * Removes the subtree defined by the node referred to by
+	 * itr (which must not be the root) and returns the number
+	 * of nodes removed.  The nodes are counted since sizes
+	 * within the subtree may not have been flushed, and the
+	 * subtree is deleted by the next flush().
+	 *
+	 * O(depth + sum of the degrees of the ancestors whose height
+	 * is recomputed + size of the subtree), holding one stripe
+	 * at a time
+	 */
+
+	template <typename Tree>
+	int Locked_tree<Tree>::erase( iterator itr ) {
+		tree_node *node = itr.current_node;
+		tree_node *par = node->parent;
+
+		assert( par != 0 );
+
+		int removed = 0;
+		std::vector<tree_node *> stack( 1, node );
+
+		while ( !stack.empty() ) {
+			tree_node *top = stack.back();
+			stack.pop_back();
+			++removed;
+
+			for ( tree_node *child = top->children_head; child != 0; child = child->next_sibling ) {
+				stack.push_back( child );
+			}
+		}
+
+		stripe &s = stripe_of( par );
+		change_list batch;
+
+		{
+			std::lock_guard<std::mutex> guard( s.lock );
+
+			par->unlink_child( node );
+			__atomic_store_n( &par->node_degree, par->node_degree - 1, __ATOMIC_RELAXED );
+			record( s, par, -removed, batch );
+			s.retired.push_back( node );
+		}
+
+		apply( s, batch );
+
+		for ( tree_node *regress = par; regress != 0; regress = regress->parent ) {
+			std::lock_guard<std::mutex> guard( stripe_of( regress ).lock );
+
+			int h = 0;
+
+			for ( tree_node *child = regress->children_head; child != 0; child = child->next_sibling ) {
+				h = std::max( h, __atomic_load_n( &child->node_height, __ATOMIC_RELAXED ) + 1 );
+			}
+
+			if ( h == regress->node_height ) {
+				break;
+			}
+
+			__atomic_store_n( &regress->node_height, h, __ATOMIC_RELAXED );
+		}
+
+		return removed;
+	}
+
+	/*
+	 * Flush
+	 *   void Locked_tree<Tree> :: flush()
+	 *
+	 * Adds each recorded change of size to the node and to
+	 * all of its ancestors and then deletes the erased
+	 * subtrees.  An erased node still refers to its former
+	 * parent, so the changes recorded within an erased subtree
+	 * reach the tree and are offset by the number of nodes
+	 * counted when it was erased.  The generation of the tree
+	 * is advanced.
+	 *
+	 * Must not be called while any writer is active.
+	 *
+	 * O(sum of the depths of the recorded nodes + size of the
+	 * erased subtrees)
+	 */
+
+	template <typename Tree>
+	void Locked_tree<Tree>::flush() {
+		++tree->structure_generation;
+		++tree->removal_generation;
+
+		for ( std::size_t k = 0; k < stripe_count; ++k ) {
+			change_list &pending = stripes[k].pending;
+
+			for ( std::size_t i = 0; i < pending.size(); ++i ) {
+				for ( tree_node *regress = pending[i].first; regress != 0; regress = regress->parent ) {
+					regress->node_size += pending[i].second;
+				}
+			}
+
+			pending.clear();
+			stripes[k].count = 0;
+		}
+
+		for ( std::size_t k = 0; k < stripe_count; ++k ) {
+			std::vector<tree_node *> &retired = stripes[k].retired;
+
+			for ( std::size_t i = 0; i < retired.size(); ++i ) {
+				retired[i]->clear();
+			}
+
+			retired.clear();
+		}
+	}
+
+	/*
+	 * Record a Change of Size
+	 *   void Locked_tree<Tree> :: record( stripe &s, tree_node *node, int d, change_list &batch )
+	 *
+	 * Records that d is to be added to the size of the node
+	 * and of its ancestors;  consecutive changes to the same
+	 * node are merged.  Once the stripe holds pending_limit
+	 * changes, they are moved to the batch to be applied after
+	 * the stripe is released.  The stripe must be held.
+	 *
+	 * O(1) amortized
+	 */
+
+	template <typename Tree>
+	void Locked_tree<Tree>::record( stripe &s, tree_node *node, int d, change_list &batch ) {
+		if ( !s.pending.empty() && s.pending.back().first == node ) {
+			s.pending.back().second += d;
+		} else {
+			s.pending.push_back( std::make_pair( node, d ) );
+		}
+
+		__atomic_fetch_add( &s.count, d, __ATOMIC_RELAXED );
+
+		if ( s.pending.size() >= pending_limit ) {
+			batch.swap( s.pending );
+		}
+	}
+
+	/*
+	 * Apply a Batch
+	 *   void Locked_tree<Tree> :: apply( stripe &s, change_list &batch )
+	 *
+	 * Sums the changes of the batch for each node and each of
+	 * its ancestors and adds each sum to the size of its node
+	 * with one atomic operation, so that the nodes near the
+	 * root are modified once per batch rather than once per
+	 * change.  The sum is then removed from the count of the
+	 * stripe s, from which the batch was taken.
+	 *
+	 * O(sum of the depths of the nodes of the batch)
+	 */
+
+	template <typename Tree>
+	void Locked_tree<Tree>::apply( stripe &s, change_list &batch ) {
+		if ( batch.empty() ) {
+			return;
+		}
+
+		std::unordered_map<tree_node *, int> sums;
+		int total = 0;
+
+		for ( std::size_t i = 0; i < batch.size(); ++i ) {
+			for ( tree_node *regress = batch[i].first; regress != 0; regress = regress->parent ) {
+				sums[regress] += batch[i].second;
+			}
+
+			total += batch[i].second;
+		}
+
+		for ( typename std::unordered_map<tree_node *, int>::iterator itr = sums.begin(); itr != sums.end(); ++itr ) {
+			if ( itr->second != 0 ) {
+				__atomic_fetch_add( &itr->first->node_size, itr->second, __ATOMIC_RELAXED );
+			}
+		}
+
+		__atomic_fetch_sub( &s.count, total, __ATOMIC_RELAXED );
+	}
+
+	/*
+	 * Stripe of a Node
+	 *   stripe &Locked_tree<Tree> :: stripe_of( tree_node const *node ) const
+	 *
+	 * Returns the stripe of the node:  the address is
+	 * divided by the alignment of the nodes and mixed with
+	 * a multiplicative hash so that nodes allocated one
+	 * after the other use different stripes.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Tree>
+	typename Locked_tree<Tree>::stripe &Locked_tree<Tree>::stripe_of( tree_node const *node ) const {
+		uintptr_t key = reinterpret_cast<uintptr_t>( node ) / sizeof( void * );
+		uint32_t mixed = static_cast<uint32_t>( key * 2654435761u );
+
+		return stripes[( mixed >> 16 ) % stripe_count];
+	}
+}
+
+#endif
@@ -0,0 +1,495 @@
+#ifndef DATA_STRUCTURES_PATH_INDEX
+#define DATA_STRUCTURES_PATH_INDEX
+
+#include <cassert>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arvores-gerais.hpp"
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *                  Path Index                  * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Path Index Class
+	 *   class Path_index<Tree, Op>
+	 *
+	 * A heavy-light decomposition of a general tree which
+	 * answers aggregate queries and applies updates along
+	 * the path between any two nodes of the tree.
+	 *
+	 * The template argument Tree is the General_tree and
+	 * Op is a subtree aggregate policy (see sum_aggregate,
+	 * min_aggregate and max_aggregate) defining lift(),
+	 * combine() and, for path_update(), apply().  The order
+	 * in which the nodes of a path are combined is not
+	 * specified, so combine() should also be commutative.
+	 *
+	 * The index is built from the sizes of the subtrees:
+	 * each node continues the chain of its child with the
+	 * largest subtree, and the chains are laid out one after
+	 * the other in a lazily propagated segment tree.  Every
+	 * path crosses O(log n) chains, so
+	 *   path_query( a, b )           is O(log^2 n), and
+	 *   path_update( a, b, d )       is O(log^2 n).
+	 *
+	 * The index is rebuilt, in O(n) if the sizes are stored,
+	 * at the next query or update after invalidate() is
+	 * called or after the generation of the tree has changed,
+	 * that is, after nodes were added, removed, moved or
+	 * compacted.  Objects replaced in the tree are not seen by
+	 * the index until it is invalidated.
+	 *
+	 * The values updated by path_update() are held by the
+	 * index:  write_back() stores them into the objects of the
+	 * tree and recomputes its hashes and subtree aggregates.
+	 * Before the index is rebuilt, the values not yet written
+	 * back are stored into the objects as well (but the hashes
+	 * and aggregates are only recomputed by write_back()),
+	 * provided no node may have been deleted since the index
+	 * was built;
+	 * otherwise the indexed nodes may no longer exist, so
+	 * write_back() must be called before nodes are removed
+	 * while updates are held (this is asserted, and the values
+	 * are discarded if assertions are disabled).
+	 ****************************************************/
+
+	template <typename Tree, typename Op>
+	class Path_index {
+		public:
+			typedef typename Tree::iterator iterator;
+			typedef typename Op::value_type value_type;
+
+			explicit Path_index( Tree & );
+
+			void invalidate();
+			value_type value( iterator );
+			value_type path_query( iterator, iterator );
+			void path_update( iterator, iterator, value_type const & );
+			void write_back();
+
+		private:
+			typedef typename Tree::tree_node tree_node;
+
+			Tree *tree;
+			bool valid;
+			bool updated;
+			int indexed_size;
+			unsigned long indexed_generation;
+			unsigned long indexed_removals;
+
+			// Indexed by the position of a node within the chains
+			std::vector<tree_node *> node_at;
+			std::vector<int> parent_of;
+			std::vector<int> head_of;
+			std::vector<int> depth_of;
+			std::unordered_map<tree_node const *, int> position;
+
+			// The segment tree over the positions
+			std::vector<value_type> segment;
+			std::vector<value_type> delta;
+			std::vector<bool> pending;
+
+			int position_of( tree_node const * ) const;
+			void refresh();
+			void rebuild();
+			void build( int, int, int );
+			void apply( int, int, int, value_type const & );
+			void push( int, int, int, int );
+			void query( int, int, int, int, int, value_type &, bool & );
+			void update( int, int, int, int, int, value_type const & );
+			void flush( int, int, int );
+	};
+
+	/*
+	 * Constructor
+	 *   Path_index<Tree, Op> :: Path_index( Tree &t )
+	 *
+	 * Creates an index over the tree which is built
+	 * when it is first used.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Tree, typename Op>
+	Path_index<Tree, Op>::Path_index( Tree &t ):
+	tree( &t ),
+	valid( false ),
+	updated( false ),
+	indexed_size( 0 ),
+	indexed_generation( 0 ),
+	indexed_removals( 0 ) {
+		// Empty constructor
+	}
+
+	/*
+	 * Invalidate
+	 *   void Path_index<Tree, Op> :: invalidate()
+	 *
+	 * Marks the index to be rebuilt at its next use.  This
+	 * must be called after objects of the tree are replaced.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::invalidate() {
+		valid = false;
+	}
+
+	/*
+	 * Value of a Node
+	 *   value_type Path_index<Tree, Op> :: value( iterator itr )
+	 *
+	 * Returns the lifted object of the referred to node
+	 * including all updates applied to it by the index.
+	 *
+	 * O(log n)
+	 */
+
+	template <typename Tree, typename Op>
+	typename Path_index<Tree, Op>::value_type Path_index<Tree, Op>::value( iterator itr ) {
+		refresh();
+
+		int p = position_of( itr.current_node );
+		value_type result = value_type();
+		bool found = false;
+
+		query( 1, 0, indexed_size - 1, p, p, result, found );
+
+		return result;
+	}
+
+	/*
+	 * Path Query
+	 *   value_type Path_index<Tree, Op> :: path_query( iterator a, iterator b )
+	 *
+	 * Returns the combination of the values of all nodes on
+	 * the path from a to b, including both a and b.  While the
+	 * two nodes are on different chains, the deeper chain head
+	 * is left by combining the segment from that head to the
+	 * node and stepping to the parent of the head.
+	 *
+	 * O(log^2 n)
+	 */
+
+	template <typename Tree, typename Op>
+	typename Path_index<Tree, Op>::value_type Path_index<Tree, Op>::path_query( iterator a, iterator b ) {
+		refresh();
+
+		int pa = position_of( a.current_node );
+		int pb = position_of( b.current_node );
+		value_type result = value_type();
+		bool found = false;
+
+		while ( head_of[pa] != head_of[pb] ) {
+			if ( depth_of[head_of[pa]] < depth_of[head_of[pb]] ) {
+				std::swap( pa, pb );
+			}
+
+			query( 1, 0, indexed_size - 1, head_of[pa], pa, result, found );
+			pa = parent_of[head_of[pa]];
+		}
+
+		if ( pa > pb ) {
+			std::swap( pa, pb );
+		}
+
+		query( 1, 0, indexed_size - 1, pa, pb, result, found );
+
+		return result;
+	}
+
+	/*
+	 * Path Update
+	 *   void Path_index<Tree, Op> :: path_update( iterator a, iterator b, value_type const &d )
+	 *
+	 * Adds d to the value of every node on the path from
+	 * a to b, including both a and b.  The segments of the
+	 * path are found as in path_query().
+	 *
+	 * O(log^2 n)
+	 */
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::path_update( iterator a, iterator b, value_type const &d ) {
+		refresh();
+
+		int pa = position_of( a.current_node );
+		int pb = position_of( b.current_node );
+
+		while ( head_of[pa] != head_of[pb] ) {
+			if ( depth_of[head_of[pa]] < depth_of[head_of[pb]] ) {
+				std::swap( pa, pb );
+			}
+
+			update( 1, 0, indexed_size - 1, head_of[pa], pa, d );
+			pa = parent_of[head_of[pa]];
+		}
+
+		if ( pa > pb ) {
+			std::swap( pa, pb );
+		}
+
+		update( 1, 0, indexed_size - 1, pa, pb, d );
+		updated = true;
+	}
+
+	/*
+	 * Write Back
+	 *   void Path_index<Tree, Op> :: write_back()
+	 *
+	 * Pushes all pending updates to the leaves of the segment
+	 * tree and stores the value of each node as its object.
+	 * The hashes and subtree aggregates of the tree are then
+	 * recomputed:  the parent of each node precedes it in the
+	 * chains, so the nodes are visited in reverse.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::write_back() {
+		refresh();
+
+		if ( updated ) {
+			flush( 1, 0, indexed_size - 1 );
+			updated = false;
+		}
+
+		for ( int p = indexed_size - 1; p >= 0; --p ) {
+			node_at[p]->update_node();
+		}
+	}
+
+	/*
+	 * Position of a Node
+	 *   int Path_index<Tree, Op> :: position_of( tree_node const *node ) const
+	 *
+	 * Returns the position of the node within the chains.
+	 * The node must be in the tree that was indexed.
+	 *
+	 * O(1) on average
+	 */
+
+	template <typename Tree, typename Op>
+	int Path_index<Tree, Op>::position_of( tree_node const *node ) const {
+		typename std::unordered_map<tree_node const *, int>::const_iterator entry = position.find( node );
+
+		assert( entry != position.end() );
+
+		return entry->second;
+	}
+
+	/*
+	 * Refresh
+	 *   void Path_index<Tree, Op> :: refresh()
+	 *
+	 * Rebuilds the index if it was invalidated or if the
+	 * generation of the tree is no longer the indexed one.
+	 * The values not yet written back are first stored into
+	 * the indexed nodes, which all still exist unless the
+	 * removals of the tree have changed.
+	 *
+	 * O(1) if the index is valid
+	 */
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::refresh() {
+		if ( valid && tree->generation() == indexed_generation ) {
+			return;
+		}
+
+		if ( updated ) {
+			assert( tree->removals() == indexed_removals );
+
+			if ( tree->removals() == indexed_removals ) {
+				flush( 1, 0, indexed_size - 1 );
+			}
+
+			updated = false;
+		}
+
+		rebuild();
+	}
+
+	/*
+	 * Rebuild
+	 *   void Path_index<Tree, Op> :: rebuild()
+	 *
+	 * Decomposes the tree into chains using an explicit stack.
+	 * When a node is popped, its light children are pushed as
+	 * the heads of new chains and its heavy child (the child
+	 * with the largest subtree) is pushed last so that it is
+	 * popped next and takes the following position.
+	 *
+	 * O(n) if the sizes of the subtrees are stored
+	 */
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::rebuild() {
+		int n = tree->size();
+
+		node_at.clear();
+		parent_of.clear();
+		head_of.clear();
+		depth_of.clear();
+		position.clear();
+
+		node_at.reserve( n );
+		parent_of.reserve( n );
+		head_of.reserve( n );
+		depth_of.reserve( n );
+		position.reserve( n );
+
+		// Each entry is a node together with the head of its chain
+		std::vector<std::pair<tree_node *, tree_node *> > stack;
+		stack.push_back( std::make_pair( tree->root_node, tree->root_node ) );
+
+		while ( !stack.empty() ) {
+			tree_node *node = stack.back().first;
+			tree_node *head = stack.back().second;
+			stack.pop_back();
+
+			int p = static_cast<int>( node_at.size() );
+			int parent = ( node->parent == 0 ) ? -1 : position_of( node->parent );
+
+			position[node] = p;
+			node_at.push_back( node );
+			parent_of.push_back( parent );
+			head_of.push_back( ( head == node ) ? p : position_of( head ) );
+			depth_of.push_back( ( parent == -1 ) ? 0 : depth_of[parent] + 1 );
+
+			tree_node *heavy = 0;
+
+			for ( tree_node *child = node->children_head; child != 0; child = child->next_sibling ) {
+				if ( heavy == 0 || child->size() > heavy->size() ) {
+					heavy = child;
+				}
+			}
+
+			for ( tree_node *child = node->children_head; child != 0; child = child->next_sibling ) {
+				if ( child != heavy ) {
+					stack.push_back( std::make_pair( child, child ) );
+				}
+			}
+
+			if ( heavy != 0 ) {
+				stack.push_back( std::make_pair( heavy, head ) );
+			}
+		}
+
+		indexed_size = n;
+		indexed_generation = tree->generation();
+		indexed_removals = tree->removals();
+		segment.assign( 4*n, value_type() );
+		delta.assign( 4*n, value_type() );
+		pending.assign( 4*n, false );
+		build( 1, 0, n - 1 );
+		valid = true;
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *           Segment Tree Definitions           * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Each segment tree node k covers the positions lo to hi
+	 * with children 2k and 2k + 1.  A pending delta of node k
+	 * has been applied to segment[k] but not yet to its children.
+	 */
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::build( int k, int lo, int hi ) {
+		if ( lo == hi ) {
+			segment[k] = Op::lift( node_at[lo]->element );
+			return;
+		}
+
+		int mid = ( lo + hi )/2;
+
+		build( 2*k, lo, mid );
+		build( 2*k + 1, mid + 1, hi );
+		segment[k] = Op::combine( segment[2*k], segment[2*k + 1] );
+	}
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::apply( int k, int lo, int hi, value_type const &d ) {
+		segment[k] = Op::apply( segment[k], d, hi - lo + 1 );
+
+		if ( lo != hi ) {
+			delta[k] = pending[k] ? delta[k] + d : d;
+			pending[k] = true;
+		}
+	}
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::push( int k, int lo, int mid, int hi ) {
+		if ( pending[k] ) {
+			apply( 2*k, lo, mid, delta[k] );
+			apply( 2*k + 1, mid + 1, hi, delta[k] );
+			pending[k] = false;
+		}
+	}
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::query( int k, int lo, int hi, int a, int b, value_type &result, bool &found ) {
+		if ( b < lo || hi < a ) {
+			return;
+		}
+
+		if ( a <= lo && hi <= b ) {
+			result = found ? Op::combine( result, segment[k] ) : segment[k];
+			found = true;
+			return;
+		}
+
+		int mid = ( lo + hi )/2;
+
+		push( k, lo, mid, hi );
+		query( 2*k, lo, mid, a, b, result, found );
+		query( 2*k + 1, mid + 1, hi, a, b, result, found );
+	}
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::update( int k, int lo, int hi, int a, int b, value_type const &d ) {
+		if ( b < lo || hi < a ) {
+			return;
+		}
+
+		if ( a <= lo && hi <= b ) {
+			apply( k, lo, hi, d );
+			return;
+		}
+
+		int mid = ( lo + hi )/2;
+
+		push( k, lo, mid, hi );
+		update( 2*k, lo, mid, a, b, d );
+		update( 2*k + 1, mid + 1, hi, a, b, d );
+		segment[k] = Op::combine( segment[2*k], segment[2*k + 1] );
+	}
+
+	template <typename Tree, typename Op>
+	void Path_index<Tree, Op>::flush( int k, int lo, int hi ) {
+		if ( lo == hi ) {
+			node_at[lo]->element = segment[k];
+			return;
+		}
+
+		int mid = ( lo + hi )/2;
+
+		push( k, lo, mid, hi );
+		flush( 2*k, lo, mid );
+		flush( 2*k + 1, mid + 1, hi );
+	}
+}
+
+#endif
@@ -0,0 +1,610 @@
+#ifndef DATA_STRUCTURES_COMPACT_TREE
+#define DATA_STRUCTURES_COMPACT_TREE
+
+#include <algorithm>
+#include <cassert>
+#include <stdint.h>
+#include <vector>
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *                 Compact Tree                 * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Compact Tree Class
+	 *   class Compact_tree<Type>
+	 *
+	 * A general tree with the same ordering as General_tree
+	 * in which all nodes are stored in a single vector (the
+	 * pool) and refer to each other by 32-bit indices into the
+	 * pool rather than by pointers.  A node stores five links,
+	 * its degree, and the height and size of its subtree:
+	 * 32 bytes plus the object, about half of a tree_node on
+	 * a 64-bit platform.  The depth is computed by following
+	 * the parent links.
+	 *
+	 * The slots of erased nodes are kept on a free list and
+	 * reused by later insertions.  The tree holds fewer than
+	 * 2^32 - 1 nodes;  the largest index marks a missing link.
+	 *
+	 * Iterators store the index of the node and a pointer to
+	 * the tree and so remain valid when the pool grows;
+	 * references to the objects returned by operator* do not.
+	 ****************************************************/
+
+	template <typename Type>
+	class Compact_tree {
+		public:
+			class iterator;
+			class depth_iterator;
+
+			Compact_tree( Type const &obj = Type() );
+
+			bool empty() const;
+			int size() const;
+			int height() const;
+			void clear();
+
+			iterator begin();
+			iterator end();
+
+			depth_iterator begin_depth();
+			depth_iterator end_depth();
+
+		private:
+			static uint32_t const null = 0xFFFFFFFFu;
+
+			struct compact_node {
+				Type element;
+				uint32_t parent;
+				uint32_t previous_sibling;
+				uint32_t next_sibling;
+				uint32_t children_head;
+				uint32_t children_tail;
+				uint32_t degree;
+				uint32_t height;
+				uint32_t size;
+			};
+
+			std::vector<compact_node> pool;
+			uint32_t free_head;
+
+			uint32_t allocate( Type const &, uint32_t );
+			void release( uint32_t );
+
+		friend class iterator;
+		friend class depth_iterator;
+	};
+
+	/****************************************************
+	 * Compact Tree Iterator Class
+	 *   class Compact_tree<Type> :: iterator
+	 *
+	 * An explicit iterator which refers to a node by its
+	 * index.  Incrementing the iterator moves to the next
+	 * sibling.  The object of the node may be accessed with
+	 * operator*, a child may be inserted, and the subtree
+	 * defined by the node may be erased.
+	 ****************************************************/
+
+	template <typename Type>
+	class Compact_tree<Type>::iterator {
+		public:
+			iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			void insert( Type const &obj );
+			void erase();
+
+			Type &operator*();
+			iterator &operator++();
+			iterator operator++( int );
+			bool operator==( iterator const &rhs ) const;
+			bool operator!=( iterator const &rhs ) const;
+
+			iterator parent();
+			iterator begin();
+			iterator end();
+
+		private:
+			Compact_tree *tree;
+			uint32_t index;
+
+			iterator( Compact_tree *, uint32_t );
+
+		friend class Compact_tree;
+	};
+
+	/****************************************************
+	 * Compact Tree Depth-first Traversal Iterator Class
+	 *   class Compact_tree<Type> :: depth_iterator
+	 *
+	 * Visits each node once in a depth-first traversal
+	 * order using a stack of the indices of the nodes yet
+	 * to be visited.
+	 ****************************************************/
+
+	template <typename Type>
+	class Compact_tree<Type>::depth_iterator {
+		public:
+			depth_iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+
+			Type &operator*();
+			depth_iterator &operator++();
+			depth_iterator operator++( int );
+			bool operator==( depth_iterator const &rhs ) const;
+			bool operator!=( depth_iterator const &rhs ) const;
+
+		private:
+			Compact_tree *tree;
+			std::vector<uint32_t> stack;
+
+			explicit depth_iterator( Compact_tree * );
+
+		friend class Compact_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *           Compact Tree Definitions           * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Constructor
+	 *   Compact_tree<Type> :: Compact_tree( Type const &obj )
+	 *
+	 * Creates a tree whose root node, at index 0, stores
+	 * the object.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	Compact_tree<Type>::Compact_tree( Type const &obj ):
+	pool(),
+	free_head( null ) {
+		allocate( obj, null );
+	}
+
+	template <typename Type>
+	bool Compact_tree<Type>::empty() const {
+		return false;
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::size() const {
+		return pool[0].size;
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::height() const {
+		return pool[0].height;
+	}
+
+	/*
+	 * Clear
+	 *   void Compact_tree<Type> :: clear()
+	 *
+	 * Removes all nodes except for the root node and
+	 * releases the memory of the pool.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type>
+	void Compact_tree<Type>::clear() {
+		pool.resize( 1 );
+		std::vector<compact_node>( pool ).swap( pool );
+
+		pool[0].children_head = null;
+		pool[0].children_tail = null;
+		pool[0].degree = 0;
+		pool[0].height = 0;
+		pool[0].size = 1;
+		free_head = null;
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::iterator Compact_tree<Type>::begin() {
+		return iterator( this, 0 );
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::iterator Compact_tree<Type>::end() {
+		return iterator( this, null );
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::depth_iterator Compact_tree<Type>::begin_depth() {
+		return depth_iterator( this );
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::depth_iterator Compact_tree<Type>::end_depth() {
+		return depth_iterator();
+	}
+
+	/*
+	 * Allocate a Node
+	 *   uint32_t Compact_tree<Type> :: allocate( Type const &obj, uint32_t par )
+	 *
+	 * Returns the index of a new leaf node storing the object,
+	 * taking the first slot on the free list if there is one
+	 * and otherwise appending a slot to the pool.  The free list
+	 * is linked through the next sibling indices.
+	 *
+	 * O(1) amortized
+	 */
+
+	template <typename Type>
+	uint32_t Compact_tree<Type>::allocate( Type const &obj, uint32_t par ) {
+		compact_node node = { obj, par, null, null, null, null, 0, 0, 1 };
+
+		if ( free_head == null ) {
+			assert( pool.size() < null );
+			pool.push_back( node );
+			return static_cast<uint32_t>( pool.size() - 1 );
+		}
+
+		uint32_t index = free_head;
+		free_head = pool[index].next_sibling;
+		pool[index] = node;
+
+		return index;
+	}
+
+	/*
+	 * Release a Subtree
+	 *   void Compact_tree<Type> :: release( uint32_t index )
+	 *
+	 * Puts the slots of the node and of all its descendants
+	 * onto the free list;  their objects are replaced by Type().
+	 * The node must already be unlinked from its parent.
+	 *
+	 * O(size of the subtree)
+	 */
+
+	template <typename Type>
+	void Compact_tree<Type>::release( uint32_t index ) {
+		std::vector<uint32_t> stack( 1, index );
+
+		while ( !stack.empty() ) {
+			uint32_t top = stack.back();
+			stack.pop_back();
+
+			for ( uint32_t child = pool[top].children_head; child != null; child = pool[child].next_sibling ) {
+				stack.push_back( child );
+			}
+
+			pool[top].element = Type();
+			pool[top].next_sibling = free_head;
+			free_head = top;
+		}
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *      Compact Tree Iterator Definitions       * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Compact_tree<Type>::iterator::iterator():
+	tree( 0 ),
+	index( null ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Compact_tree<Type>::iterator::iterator( Compact_tree *t, uint32_t n ):
+	tree( t ),
+	index( n ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::iterator::degree() const {
+		return tree->pool[index].degree;
+	}
+
+	/*
+	 * Depth of a Tree Node
+	 *   int Compact_tree<Type>::iterator :: depth() const
+	 *
+	 * Counts the strict ancestors of the node.
+	 *
+	 * O(depth)
+	 */
+
+	template <typename Type>
+	int Compact_tree<Type>::iterator::depth() const {
+		int count = 0;
+
+		for ( uint32_t regress = tree->pool[index].parent; regress != null; regress = tree->pool[regress].parent ) {
+			++count;
+		}
+
+		return count;
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::iterator::height() const {
+		return tree->pool[index].height;
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::iterator::size() const {
+		return tree->pool[index].size;
+	}
+
+	template <typename Type>
+	bool Compact_tree<Type>::iterator::leaf() const {
+		return tree->pool[index].children_head == null;
+	}
+
+	template <typename Type>
+	bool Compact_tree<Type>::iterator::root() const {
+		return tree->pool[index].parent == null;
+	}
+
+	/*
+	 * Insert a New Type as a Child of the Currently Referred To Node
+	 *   void Compact_tree<Type>::iterator :: insert( Type const &obj )
+	 *
+	 * Appends a new leaf node storing the object to the children
+	 * of the current node and updates the degree of the current
+	 * node, the heights of its ancestors (stopping at the first
+	 * which is unchanged) and the sizes of it and its ancestors.
+	 *
+	 * The pool may grow, so the node is accessed by index
+	 * only after the new node is allocated.
+	 *
+	 * O(depth) amortized
+	 */
+
+	template <typename Type>
+	void Compact_tree<Type>::iterator::insert( Type const &obj ) {
+		std::vector<compact_node> &pool = tree->pool;
+		uint32_t child = tree->allocate( obj, index );
+		uint32_t tail = pool[index].children_tail;
+
+		pool[child].previous_sibling = tail;
+
+		if ( tail == null ) {
+			pool[index].children_head = child;
+		} else {
+			pool[tail].next_sibling = child;
+		}
+
+		pool[index].children_tail = child;
+		++pool[index].degree;
+
+		for (
+			uint32_t current = child, regress = index;
+			regress != null && pool[regress].height < pool[current].height + 1;
+			current = regress, regress = pool[regress].parent
+		) {
+			pool[regress].height = pool[current].height + 1;
+		}
+
+		for ( uint32_t regress = index; regress != null; regress = pool[regress].parent ) {
+			++pool[regress].size;
+		}
+	}
+
+	/*
+	 * Erase the Subtree Defined by the Currently Referred To Node
+	 *   void Compact_tree<Type>::iterator :: erase()
+	 *
+	 * Unlinks the node from its parent, releases the slots of
+	 * its subtree and updates the degree of the parent and the
+	 * sizes and heights of the ancestors.  The height of each
+	 * ancestor is recomputed from its children, stopping at the
+	 * first which is unchanged.  The root node cannot be erased.
+	 *
+	 * The iterator refers to the end afterwards.
+	 *
+	 * O(size of the subtree + sum of the degrees of the ancestors)
+	 */
+
+	template <typename Type>
+	void Compact_tree<Type>::iterator::erase() {
+		std::vector<compact_node> &pool = tree->pool;
+		uint32_t par = pool[index].parent;
+
+		assert( par != null );
+
+		uint32_t previous = pool[index].previous_sibling;
+		uint32_t next = pool[index].next_sibling;
+
+		if ( next == null ) {
+			pool[par].children_tail = previous;
+		} else {
+			pool[next].previous_sibling = previous;
+		}
+
+		if ( previous == null ) {
+			pool[par].children_head = next;
+		} else {
+			pool[previous].next_sibling = next;
+		}
+
+		--pool[par].degree;
+
+		for ( uint32_t regress = par; regress != null; regress = pool[regress].parent ) {
+			pool[regress].size -= pool[index].size;
+		}
+
+		for ( uint32_t regress = par; regress != null; regress = pool[regress].parent ) {
+			uint32_t h = 0;
+
+			for ( uint32_t child = pool[regress].children_head; child != null; child = pool[child].next_sibling ) {
+				h = std::max( h, pool[child].height + 1 );
+			}
+
+			if ( h == pool[regress].height ) {
+				break;
+			}
+
+			pool[regress].height = h;
+		}
+
+		tree->release( index );
+		index = null;
+	}
+
+	template <typename Type>
+	Type &Compact_tree<Type>::iterator::operator*() {
+		return tree->pool[index].element;
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::iterator &Compact_tree<Type>::iterator::operator++() {
+		index = tree->pool[index].next_sibling;
+		return *this;
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::iterator Compact_tree<Type>::iterator::operator++( int ) {
+		iterator copy = *this;
+		index = tree->pool[index].next_sibling;
+		return copy;
+	}
+
+	template <typename Type>
+	bool Compact_tree<Type>::iterator::operator==( iterator const &rhs ) const {
+		return index == rhs.index;
+	}
+
+	template <typename Type>
+	bool Compact_tree<Type>::iterator::operator!=( iterator const &rhs ) const {
+		return index != rhs.index;
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::iterator Compact_tree<Type>::iterator::parent() {
+		return iterator( tree, tree->pool[index].parent );
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::iterator Compact_tree<Type>::iterator::begin() {
+		return iterator( tree, tree->pool[index].children_head );
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::iterator Compact_tree<Type>::iterator::end() {
+		return iterator( tree, null );
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *   Compact Tree Depth Iterator Definitions    * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Compact_tree<Type>::depth_iterator::depth_iterator():
+	tree( 0 ),
+	stack() {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Compact_tree<Type>::depth_iterator::depth_iterator( Compact_tree *t ):
+	tree( t ),
+	stack( 1, 0 ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::depth_iterator::degree() const {
+		return tree->pool[stack.back()].degree;
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::depth_iterator::depth() const {
+		return iterator( tree, stack.back() ).depth();
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::depth_iterator::height() const {
+		return tree->pool[stack.back()].height;
+	}
+
+	template <typename Type>
+	int Compact_tree<Type>::depth_iterator::size() const {
+		return tree->pool[stack.back()].size;
+	}
+
+	template <typename Type>
+	bool Compact_tree<Type>::depth_iterator::leaf() const {
+		return tree->pool[stack.back()].children_head == null;
+	}
+
+	template <typename Type>
+	Type &Compact_tree<Type>::depth_iterator::operator*() {
+		return tree->pool[stack.back()].element;
+	}
+
+	/*
+	 * Increment
+	 *   depth_iterator &Compact_tree<Type>::depth_iterator :: operator++()
+	 *
+	 * Pops the current node and pushes its children from
+	 * the last to the first using the previous sibling links.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Type>
+	typename Compact_tree<Type>::depth_iterator &Compact_tree<Type>::depth_iterator::operator++() {
+		uint32_t top = stack.back();
+		stack.pop_back();
+
+		for ( uint32_t child = tree->pool[top].children_tail; child != null; child = tree->pool[child].previous_sibling ) {
+			stack.push_back( child );
+		}
+
+		return *this;
+	}
+
+	template <typename Type>
+	typename Compact_tree<Type>::depth_iterator Compact_tree<Type>::depth_iterator::operator++( int ) {
+		depth_iterator copy = *this;
+		++( *this );
+		return copy;
+	}
+
+	/*
+	 * Two depth iterators are equal if both are at the end
+	 * or if both have the same stack.
+	 */
+
+	template <typename Type>
+	bool Compact_tree<Type>::depth_iterator::operator==( depth_iterator const &rhs ) const {
+		return stack == rhs.stack;
+	}
+
+	template <typename Type>
+	bool Compact_tree<Type>::depth_iterator::operator!=( depth_iterator const &rhs ) const {
+		return !( *this == rhs );
+	}
+}
+
+#endif
@@ -0,0 +1,606 @@
+#ifndef DATA_STRUCTURES_COMPRESSED_TREE
+#define DATA_STRUCTURES_COMPRESSED_TREE
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arvores-gerais.hpp"
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *               Compressed Tree                * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Compressed Tree Class
+	 *   class Compressed_tree<Type>
+	 *
+	 * A read-only copy of a general tree in which all equal
+	 * subtrees (storing equal objects in the same shape) are
+	 * stored once and shared:  the tree is represented by a
+	 * directed acyclic graph of distinct subtrees.  For trees
+	 * with many repeated subtrees, distinct() may be orders of
+	 * magnitude smaller than size().
+	 *
+	 * Each distinct subtree stores its object, its degree,
+	 * its size and height, and the position of the list of
+	 * the identifiers of its children.  The subtrees are
+	 * found by hash-consing:  a subtree is looked up by the
+	 * hash of its object and of the identifiers of its
+	 * children, which are already canonical, so comparing
+	 * two candidates is O(degree).
+	 *
+	 * A shared subtree has no unique parent or depth;  the
+	 * iterators record the parent and depth of the node as
+	 * they descend from the root.
+	 *
+	 * The objects must be comparable with == and hashable
+	 * with std::hash.
+	 ****************************************************/
+
+	template <typename Type>
+	class Compressed_tree {
+		public:
+			class iterator;
+			class depth_iterator;
+
+			template <typename Metadata, typename Children, typename Aggregate>
+			explicit Compressed_tree( General_tree<Type, Metadata, Children, Aggregate> & );
+
+			int size() const;
+			int height() const;
+			int distinct() const;
+
+			iterator begin() const;
+			iterator end() const;
+
+			depth_iterator begin_depth() const;
+			depth_iterator end_depth() const;
+
+		private:
+			struct dag_node {
+				Type element;
+				int first_child;
+				int degree;
+				int size;
+				int height;
+			};
+
+			std::vector<dag_node> nodes;
+			std::vector<int> child_ids;
+			int root_id;
+
+			int intern( Type const &, std::vector<int> const &, int,
+			            std::unordered_multimap<std::size_t, int> & );
+
+		friend class iterator;
+		friend class depth_iterator;
+	};
+
+	/****************************************************
+	 * Compressed Tree Iterator Class
+	 *   class Compressed_tree<Type> :: iterator
+	 *
+	 * An explicit iterator which refers to a node of the
+	 * tree together with the parent it was reached from, its
+	 * position among the children of that parent and its
+	 * depth.  Incrementing the iterator moves to the next
+	 * sibling;  the end of the children of a node is the
+	 * position one past the last child.
+	 ****************************************************/
+
+	template <typename Type>
+	class Compressed_tree<Type>::iterator {
+		public:
+			iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			Type const &operator*() const;
+			iterator &operator++();
+			iterator operator++( int );
+			bool operator==( iterator const &rhs ) const;
+			bool operator!=( iterator const &rhs ) const;
+
+			iterator begin() const;
+			iterator end() const;
+			iterator child( int k ) const;
+
+		private:
+			Compressed_tree const *tree;
+			int node_id;
+			int parent_id;
+			int position;
+			int node_depth;
+
+			iterator( Compressed_tree const *, int, int, int, int );
+
+		friend class Compressed_tree;
+	};
+
+	/****************************************************
+	 * Compressed Tree Depth-first Traversal Iterator Class
+	 *   class Compressed_tree<Type> :: depth_iterator
+	 *
+	 * Visits every node of the expanded tree once in a
+	 * depth-first traversal order using a stack of the
+	 * identifiers and depths of the nodes yet to be visited.
+	 * A shared subtree is visited once for each place it
+	 * occurs in the tree.
+	 ****************************************************/
+
+	template <typename Type>
+	class Compressed_tree<Type>::depth_iterator {
+		public:
+			depth_iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+
+			Type const &operator*() const;
+			depth_iterator &operator++();
+			depth_iterator operator++( int );
+			bool operator==( depth_iterator const &rhs ) const;
+			bool operator!=( depth_iterator const &rhs ) const;
+
+		private:
+			Compressed_tree const *tree;
+			std::vector<std::pair<int, int> > stack;
+
+			explicit depth_iterator( Compressed_tree const * );
+
+		friend class Compressed_tree;
+	};
+
+	/*
+	 * Compress
+	 *   Compressed_tree<Type> compress( General_tree<Type, ...> &tree )
+	 *
+	 * Returns the compressed copy of the general tree.
+	 *
+	 * O(n) expected
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	Compressed_tree<Type> compress( General_tree<Type, Metadata, Children, Aggregate> &tree ) {
+		return Compressed_tree<Type>( tree );
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *         Compressed Tree Definitions          * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Constructor
+	 *   Compressed_tree<Type> :: Compressed_tree( General_tree<Type, ...> &tree )
+	 *
+	 * Visits the general tree in post-order with an explicit
+	 * stack so that the identifiers of all children of a node
+	 * are known when the node is interned.  The identifiers of
+	 * the children of the nodes on the stack are kept on a
+	 * second stack, pending.  The table of distinct subtrees
+	 * is only needed while the tree is compressed.
+	 *
+	 * O(n) expected
+	 */
+
+	template <typename Type>
+	template <typename Metadata, typename Children, typename Aggregate>
+	Compressed_tree<Type>::Compressed_tree( General_tree<Type, Metadata, Children, Aggregate> &tree ):
+	nodes(),
+	child_ids(),
+	root_id( 0 ) {
+		typedef typename General_tree<Type, Metadata, Children, Aggregate>::iterator tree_iterator;
+
+		// Each entry is a node, its next child to be visited and
+		// the position of the identifiers of its children in pending
+		struct frame {
+			tree_iterator node;
+			tree_iterator next;
+			std::size_t first;
+		};
+
+		std::unordered_multimap<std::size_t, int> table;
+		std::vector<int> pending;
+		std::vector<frame> stack;
+
+		frame top = { tree.begin(), tree.begin().begin(), 0 };
+		stack.push_back( top );
+
+		while ( true ) {
+			if ( stack.back().next != stack.back().node.end() ) {
+				tree_iterator child = stack.back().next;
+				++stack.back().next;
+
+				frame next = { child, child.begin(), pending.size() };
+				stack.push_back( next );
+			} else {
+				std::size_t first = stack.back().first;
+				int id = intern( *stack.back().node, pending, static_cast<int>( first ), table );
+
+				pending.resize( first );
+				stack.pop_back();
+
+				if ( stack.empty() ) {
+					root_id = id;
+					return;
+				}
+
+				pending.push_back( id );
+			}
+		}
+	}
+
+	/*
+	 * Intern a Subtree
+	 *   int Compressed_tree<Type> :: intern( Type const &obj, std::vector<int> const &pending, int first, table )
+	 *
+	 * Returns the identifier of the subtree storing obj whose
+	 * children are the subtrees with the identifiers in pending
+	 * from position first on, adding the subtree if it is not
+	 * yet in the table.
+	 *
+	 * O(degree) expected
+	 */
+
+	template <typename Type>
+	int Compressed_tree<Type>::intern( Type const &obj, std::vector<int> const &pending, int first,
+	                                   std::unordered_multimap<std::size_t, int> &table ) {
+		int degree = static_cast<int>( pending.size() ) - first;
+		std::size_t key = hash_element( obj );
+
+		for ( int i = first; i < first + degree; ++i ) {
+			key = hash_combine( key, pending[i] );
+		}
+
+		typedef std::unordered_multimap<std::size_t, int>::const_iterator table_iterator;
+		std::pair<table_iterator, table_iterator> range = table.equal_range( key );
+
+		for ( table_iterator candidate = range.first; candidate != range.second; ++candidate ) {
+			dag_node const &node = nodes[candidate->second];
+
+			if ( node.degree == degree && node.element == obj &&
+			     std::equal( pending.begin() + first, pending.end(), child_ids.begin() + node.first_child ) ) {
+				return candidate->second;
+			}
+		}
+
+		dag_node node = { obj, static_cast<int>( child_ids.size() ), degree, 1, 0 };
+
+		for ( int i = first; i < first + degree; ++i ) {
+			node.size += nodes[pending[i]].size;
+			node.height = std::max( node.height, nodes[pending[i]].height + 1 );
+			child_ids.push_back( pending[i] );
+		}
+
+		int id = static_cast<int>( nodes.size() );
+		nodes.push_back( node );
+		table.insert( std::make_pair( key, id ) );
+
+		return id;
+	}
+
+	/*
+	 * Size
+	 *   int Compressed_tree<Type> :: size() const
+	 *
+	 * Returns the number of nodes within the tree, counting
+	 * each occurrence of a shared subtree.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	int Compressed_tree<Type>::size() const {
+		return nodes[root_id].size;
+	}
+
+	/*
+	 * Height
+	 *   int Compressed_tree<Type> :: height() const
+	 *
+	 * Returns the height of the tree.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	int Compressed_tree<Type>::height() const {
+		return nodes[root_id].height;
+	}
+
+	/*
+	 * Distinct Subtrees
+	 *   int Compressed_tree<Type> :: distinct() const
+	 *
+	 * Returns the number of distinct subtrees, each of
+	 * which is stored once.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	int Compressed_tree<Type>::distinct() const {
+		return static_cast<int>( nodes.size() );
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::iterator Compressed_tree<Type>::begin() const {
+		return iterator( this, root_id, -1, 0, 0 );
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::iterator Compressed_tree<Type>::end() const {
+		return iterator( this, -1, -1, 1, 0 );
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::depth_iterator Compressed_tree<Type>::begin_depth() const {
+		return depth_iterator( this );
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::depth_iterator Compressed_tree<Type>::end_depth() const {
+		return depth_iterator();
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *     Compressed Tree Iterator Definitions     * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Compressed_tree<Type>::iterator::iterator():
+	tree( 0 ),
+	node_id( -1 ),
+	parent_id( -1 ),
+	position( 1 ),
+	node_depth( 0 ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Compressed_tree<Type>::iterator::iterator( Compressed_tree const *t, int id, int par, int pos, int d ):
+	tree( t ),
+	node_id( id ),
+	parent_id( par ),
+	position( pos ),
+	node_depth( d ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	int Compressed_tree<Type>::iterator::degree() const {
+		return tree->nodes[node_id].degree;
+	}
+
+	/*
+	 * Depth
+	 *   int Compressed_tree<Type>::iterator :: depth() const
+	 *
+	 * Returns the depth recorded as the iterator descended
+	 * from the root node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	int Compressed_tree<Type>::iterator::depth() const {
+		return node_depth;
+	}
+
+	template <typename Type>
+	int Compressed_tree<Type>::iterator::height() const {
+		return tree->nodes[node_id].height;
+	}
+
+	template <typename Type>
+	int Compressed_tree<Type>::iterator::size() const {
+		return tree->nodes[node_id].size;
+	}
+
+	template <typename Type>
+	bool Compressed_tree<Type>::iterator::leaf() const {
+		return tree->nodes[node_id].degree == 0;
+	}
+
+	template <typename Type>
+	bool Compressed_tree<Type>::iterator::root() const {
+		return node_depth == 0;
+	}
+
+	template <typename Type>
+	Type const &Compressed_tree<Type>::iterator::operator*() const {
+		return tree->nodes[node_id].element;
+	}
+
+	/*
+	 * Next Sibling
+	 *   iterator &Compressed_tree<Type>::iterator :: operator++()
+	 *
+	 * Moves to the next child of the parent the node was
+	 * reached from, or to the end of its children.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	typename Compressed_tree<Type>::iterator &Compressed_tree<Type>::iterator::operator++() {
+		++position;
+
+		if ( parent_id == -1 || position >= tree->nodes[parent_id].degree ) {
+			node_id = -1;
+		} else {
+			node_id = tree->child_ids[tree->nodes[parent_id].first_child + position];
+		}
+
+		return *this;
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::iterator Compressed_tree<Type>::iterator::operator++( int ) {
+		iterator copy = *this;
+		++( *this );
+		return copy;
+	}
+
+	template <typename Type>
+	bool Compressed_tree<Type>::iterator::operator==( iterator const &rhs ) const {
+		return node_id == rhs.node_id && ( node_id != -1 || parent_id == rhs.parent_id );
+	}
+
+	template <typename Type>
+	bool Compressed_tree<Type>::iterator::operator!=( iterator const &rhs ) const {
+		return !( *this == rhs );
+	}
+
+	/*
+	 * Children
+	 *   iterator Compressed_tree<Type>::iterator :: begin() const
+	 *   iterator Compressed_tree<Type>::iterator :: end() const
+	 *   iterator Compressed_tree<Type>::iterator :: child( int k ) const
+	 *
+	 * Return iterators referring to the first child, to the end
+	 * of the children and to the kth child (or the end if there is
+	 * no kth child);  their depth is one greater.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	typename Compressed_tree<Type>::iterator Compressed_tree<Type>::iterator::begin() const {
+		return child( 0 );
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::iterator Compressed_tree<Type>::iterator::end() const {
+		return iterator( tree, -1, node_id, tree->nodes[node_id].degree, node_depth + 1 );
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::iterator Compressed_tree<Type>::iterator::child( int k ) const {
+		dag_node const &node = tree->nodes[node_id];
+
+		if ( k < 0 || k >= node.degree ) {
+			return end();
+		}
+
+		return iterator( tree, tree->child_ids[node.first_child + k], node_id, k, node_depth + 1 );
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *  Compressed Tree Depth Iterator Definitions  * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Compressed_tree<Type>::depth_iterator::depth_iterator():
+	tree( 0 ),
+	stack() {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Compressed_tree<Type>::depth_iterator::depth_iterator( Compressed_tree const *t ):
+	tree( t ),
+	stack( 1, std::make_pair( t->root_id, 0 ) ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	int Compressed_tree<Type>::depth_iterator::degree() const {
+		return tree->nodes[stack.back().first].degree;
+	}
+
+	template <typename Type>
+	int Compressed_tree<Type>::depth_iterator::depth() const {
+		return stack.back().second;
+	}
+
+	template <typename Type>
+	int Compressed_tree<Type>::depth_iterator::height() const {
+		return tree->nodes[stack.back().first].height;
+	}
+
+	template <typename Type>
+	int Compressed_tree<Type>::depth_iterator::size() const {
+		return tree->nodes[stack.back().first].size;
+	}
+
+	template <typename Type>
+	bool Compressed_tree<Type>::depth_iterator::leaf() const {
+		return tree->nodes[stack.back().first].degree == 0;
+	}
+
+	template <typename Type>
+	Type const &Compressed_tree<Type>::depth_iterator::operator*() const {
+		return tree->nodes[stack.back().first].element;
+	}
+
+	/*
+	 * Increment
+	 *   depth_iterator &Compressed_tree<Type>::depth_iterator :: operator++()
+	 *
+	 * Pops the current node and pushes its children in reverse
+	 * order with a depth one greater.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Type>
+	typename Compressed_tree<Type>::depth_iterator &Compressed_tree<Type>::depth_iterator::operator++() {
+		int id = stack.back().first;
+		int d = stack.back().second + 1;
+		stack.pop_back();
+
+		dag_node const &node = tree->nodes[id];
+
+		for ( int k = node.degree - 1; k >= 0; --k ) {
+			stack.push_back( std::make_pair( tree->child_ids[node.first_child + k], d ) );
+		}
+
+		return *this;
+	}
+
+	template <typename Type>
+	typename Compressed_tree<Type>::depth_iterator Compressed_tree<Type>::depth_iterator::operator++( int ) {
+		depth_iterator copy = *this;
+		++( *this );
+		return copy;
+	}
+
+	/*
+	 * Two depth iterators are equal if both are at the end
+	 * or if both have the same stack.
+	 */
+
+	template <typename Type>
+	bool Compressed_tree<Type>::depth_iterator::operator==( depth_iterator const &rhs ) const {
+		return stack == rhs.stack;
+	}
+
+	template <typename Type>
+	bool Compressed_tree<Type>::depth_iterator::operator!=( depth_iterator const &rhs ) const {
+		return !( *this == rhs );
+	}
+}
+
+#endif
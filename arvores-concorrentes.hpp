@@ -0,0 +1,821 @@
+#ifndef DATA_STRUCTURES_CONCURRENT_TREE
+#define DATA_STRUCTURES_CONCURRENT_TREE
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *               Concurrent Tree                * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Concurrent Tree Class
+	 *   class Concurrent_tree<Type>
+	 *
+	 * A general tree with the same ordering as General_tree
+	 * which may be read and extended by any number of threads
+	 * at once.  Readers take no lock:  a reader thread creates
+	 * a read_guard and then uses iterators, all of which remain
+	 * valid until the guard is destroyed, even if the nodes are
+	 * erased.  Children are appended by insert() without a lock
+	 * and erasures are serialized by a mutex.
+	 *
+	 * The child, sibling and metadata fields of each node are
+	 * atomic.  A new node is fully constructed before it is
+	 * linked by a single compare-and-swap on the next sibling
+	 * of the last child (or on the children head), so readers
+	 * see each append either entirely or not at all.  The tail
+	 * of each list of children is only a hint which appenders
+	 * advance, as in a lock-free queue.
+	 *
+	 * An erased node is first sealed by marking its link to
+	 * its next sibling, so that nothing can be appended after
+	 * it, and is then unlinked from its parent:  the links
+	 * within its subtree are unchanged, so a reader within it
+	 * continues to its former siblings.  The degree and size
+	 * are updated with atomic increments and the heights with
+	 * compare-and-swap;  they are updated after the links and
+	 * may briefly disagree with them.
+	 *
+	 * Erased subtrees are retired rather than deleted, using
+	 * epoch-based reclamation:  each erasure advances a global
+	 * epoch, each active read_guard announces the epoch in
+	 * which it began, and a retired subtree is deleted once
+	 * every active guard began in a later epoch.  Since an
+	 * appender may still move the tail hint of the parent back
+	 * to an erased node, each subtree is retired twice:  once
+	 * no guard remains from before it was unlinked, the hint is
+	 * moved off the node, which is retired again and deleted
+	 * once no guard remains from before the hint was moved.
+	 * Retired subtrees are reclaimed by erase() and reclaim()
+	 * and by the destructor.
+	 *
+	 * The elements of nodes are never modified, and a node may
+	 * not be erased while another thread inserts within its
+	 * subtree.  At most max_readers guards may be active at
+	 * once (insert() uses one internally):  a further guard
+	 * waits for one of them to be destroyed.
+	 ****************************************************/
+
+	template <typename Type>
+	class Concurrent_tree {
+		public:
+			class iterator;
+			class read_guard;
+
+			explicit Concurrent_tree( Type const &obj = Type(), int max_readers = 64 );
+			~Concurrent_tree();
+
+			bool empty() const;
+			int size() const;
+			int height() const;
+
+			iterator begin() const;
+			iterator end() const;
+
+			iterator insert( iterator parent, Type const &obj );
+			int erase( iterator itr );
+			int reclaim();
+			int retired() const;
+
+		private:
+			// The lowest bit of the link to the next sibling seals the node
+			static uintptr_t const sealed = 1;
+
+			struct concurrent_node {
+				Type element;
+				concurrent_node *parent;
+				int node_depth;
+				std::atomic<uintptr_t> next_link;
+				std::atomic<concurrent_node *> children_head;
+				std::atomic<concurrent_node *> children_tail;
+				std::atomic<int> degree;
+				std::atomic<int> height;
+				std::atomic<int> size;
+
+				// Set before the node is linked and then only by erasers
+				concurrent_node *previous_sibling;
+
+				concurrent_node( Type const &, concurrent_node *, int );
+				concurrent_node *next_sibling() const;
+			};
+
+			// Each slot occupies its own cache line;  0 marks an idle slot
+			struct reader_slot {
+				std::atomic<unsigned long> epoch;
+				char padding[64 - sizeof( std::atomic<unsigned long> )];
+
+				reader_slot():epoch( 0 ) {}
+			};
+
+			struct retired_subtree {
+				concurrent_node *node;
+				unsigned long epoch;
+				bool detached;
+			};
+
+			concurrent_node *root_node;
+			std::atomic<unsigned long> global_epoch;
+			mutable std::vector<reader_slot> slots;
+			std::vector<retired_subtree> retired_list;
+			std::mutex erase_lock;
+
+			static concurrent_node *node_of( uintptr_t );
+			static concurrent_node *last_child( concurrent_node * );
+			static void raise_height( concurrent_node *, int );
+			int reclaim_retired();
+			static void destroy( concurrent_node * );
+
+			// Copying a concurrent tree is not supported
+			Concurrent_tree( Concurrent_tree const & );
+			Concurrent_tree &operator=( Concurrent_tree const & );
+
+		friend class iterator;
+		friend class read_guard;
+	};
+
+	/****************************************************
+	 * Read Guard Class
+	 *   class Concurrent_tree<Type> :: read_guard
+	 *
+	 * While a read guard exists, no node which was in the
+	 * tree when it was created is deleted.  The guard claims
+	 * a reader slot of the tree, starting at a position chosen
+	 * by hashing the identifier of the thread, and announces
+	 * the current epoch in it;  the destructor releases the
+	 * slot.  Guards are cheap and should be short-lived:  a
+	 * long-lived guard prevents all later retired subtrees
+	 * from being reclaimed.
+	 ****************************************************/
+
+	template <typename Type>
+	class Concurrent_tree<Type>::read_guard {
+		public:
+			explicit read_guard( Concurrent_tree const & );
+			~read_guard();
+
+		private:
+			std::atomic<unsigned long> *slot;
+
+			// Copying a read guard is not supported
+			read_guard( read_guard const & );
+			read_guard &operator=( read_guard const & );
+	};
+
+	/****************************************************
+	 * Concurrent Tree Iterator Class
+	 *   class Concurrent_tree<Type> :: iterator
+	 *
+	 * An explicit iterator which refers to a node.
+	 * Incrementing the iterator moves to the next sibling.
+	 * An iterator may only be used while its thread holds the
+	 * read guard under which it was obtained or, without a
+	 * guard, while the node has certainly not been erased.
+	 ****************************************************/
+
+	template <typename Type>
+	class Concurrent_tree<Type>::iterator {
+		public:
+			iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			Type const &operator*() const;
+			iterator &operator++();
+			iterator operator++( int );
+			bool operator==( iterator const &rhs ) const;
+			bool operator!=( iterator const &rhs ) const;
+
+			iterator parent() const;
+			iterator begin() const;
+			iterator end() const;
+
+		private:
+			concurrent_node *current_node;
+
+			explicit iterator( concurrent_node * );
+
+		friend class Concurrent_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *         Concurrent Tree Definitions          * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Concurrent_tree<Type>::concurrent_node::concurrent_node( Type const &obj, concurrent_node *par, int d ):
+	element( obj ),
+	parent( par ),
+	node_depth( d ),
+	next_link( 0 ),
+	children_head( 0 ),
+	children_tail( 0 ),
+	degree( 0 ),
+	height( 0 ),
+	size( 1 ),
+	previous_sibling( 0 ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::concurrent_node *Concurrent_tree<Type>::concurrent_node::next_sibling() const {
+		return node_of( next_link.load( std::memory_order_acquire ) );
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::concurrent_node *Concurrent_tree<Type>::node_of( uintptr_t link ) {
+		return reinterpret_cast<concurrent_node *>( link & ~sealed );
+	}
+
+	/*
+	 * Constructor
+	 *   Concurrent_tree<Type> :: Concurrent_tree( Type const &obj, int max_readers )
+	 *
+	 * Creates a tree whose root node stores the object and
+	 * which allows up to max_readers active read guards.
+	 *
+	 * O(max_readers)
+	 */
+
+	template <typename Type>
+	Concurrent_tree<Type>::Concurrent_tree( Type const &obj, int max_readers ):
+	root_node( new concurrent_node( obj, 0, 0 ) ),
+	global_epoch( 1 ),
+	slots( std::max( max_readers, 1 ) ),
+	retired_list() {
+		// Empty constructor
+	}
+
+	/*
+	 * Destructor
+	 *   Concurrent_tree<Type> :: ~Concurrent_tree()
+	 *
+	 * Deletes all nodes, including those of retired
+	 * subtrees.  No read guard may be active.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type>
+	Concurrent_tree<Type>::~Concurrent_tree() {
+		for ( std::size_t k = 0; k < retired_list.size(); ++k ) {
+			destroy( retired_list[k].node );
+		}
+
+		destroy( root_node );
+	}
+
+	template <typename Type>
+	bool Concurrent_tree<Type>::empty() const {
+		return false;
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::size() const {
+		return root_node->size.load( std::memory_order_relaxed );
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::height() const {
+		return root_node->height.load( std::memory_order_relaxed );
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator Concurrent_tree<Type>::begin() const {
+		return iterator( root_node );
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator Concurrent_tree<Type>::end() const {
+		return iterator( 0 );
+	}
+
+	/*
+	 * Insert
+	 *   iterator Concurrent_tree<Type> :: insert( iterator parent, Type const &obj )
+	 *
+	 * Appends a new child storing the object to the node
+	 * referred to by parent and returns an iterator referring
+	 * to it.  Any number of threads may insert at once, also
+	 * into the same node.
+	 *
+	 * The child is linked by a compare-and-swap of 0 to the
+	 * child on the next sibling link of the node to which the
+	 * tail hint refers (or on the children head if the hint is
+	 * 0).  If that link is not 0, the hint is behind and is
+	 * first advanced to the next sibling;  if the node is
+	 * sealed and last, it is being erased and the hint is
+	 * moved to the last child found from the head.  A failed
+	 * compare-and-swap means another child was appended, so
+	 * no thread waits on another except on an erasure.
+	 *
+	 * The degree and the sizes of the ancestors are then
+	 * incremented and their heights raised.
+	 *
+	 * O(depth) without contention
+	 */
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator Concurrent_tree<Type>::insert( iterator parent, Type const &obj ) {
+		read_guard guard( *this );
+
+		concurrent_node *par = parent.current_node;
+		concurrent_node *child = new concurrent_node( obj, par, par->node_depth + 1 );
+
+		while ( true ) {
+			concurrent_node *last = par->children_tail.load();
+
+			if ( last == 0 ) {
+				concurrent_node *head = 0;
+				child->previous_sibling = 0;
+
+				if ( par->children_head.compare_exchange_strong( head, child ) ) {
+					par->children_tail.compare_exchange_strong( last, child );
+					break;
+				}
+
+				// Another first child was linked:  help set the hint
+				par->children_tail.compare_exchange_strong( last, head );
+				continue;
+			}
+
+			uintptr_t link = last->next_link.load();
+
+			if ( link == 0 ) {
+				child->previous_sibling = last;
+
+				if ( last->next_link.compare_exchange_strong( link, reinterpret_cast<uintptr_t>( child ) ) ) {
+					par->children_tail.compare_exchange_strong( last, child );
+					break;
+				}
+			} else if ( link != sealed ) {
+				par->children_tail.compare_exchange_strong( last, node_of( link ) );
+			} else {
+				concurrent_node *end = last_child( par );
+
+				if ( end != 0 && end->next_link.load() == sealed ) {
+					std::this_thread::yield();
+				} else {
+					par->children_tail.compare_exchange_strong( last, end );
+				}
+			}
+		}
+
+		par->degree.fetch_add( 1, std::memory_order_relaxed );
+
+		for ( concurrent_node *regress = par; regress != 0; regress = regress->parent ) {
+			regress->size.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		raise_height( par, 1 );
+
+		return iterator( child );
+	}
+
+	/*
+	 * Erase
+	 *   int Concurrent_tree<Type> :: erase( iterator itr )
+	 *
+	 * Unlinks the subtree defined by the node referred to by
+	 * itr (which must not be the root) from its parent, updates
+	 * the degree, sizes and heights of the ancestors, retires
+	 * the subtree in the current epoch and advances the epoch.
+	 * Returns the number of nodes in the subtree.
+	 *
+	 * The node is sealed first:  once its next sibling link is
+	 * marked, no child can be appended after it, so linking its
+	 * previous sibling (or the children head) to its next
+	 * sibling cannot lose an append.  The links within the
+	 * subtree are left unchanged so that readers within it
+	 * may continue.
+	 *
+	 * A height is lowered by a compare-and-swap and then
+	 * recomputed from the children once more:  an appender
+	 * which raised a child and found the old height sufficient
+	 * did so before the new height was stored, so its child
+	 * is seen and the height is raised again.  The heights are
+	 * updated from the parent upwards until one is unchanged.
+	 *
+	 * O(depth + sum of the degrees of the ancestors + max_readers)
+	 */
+
+	template <typename Type>
+	int Concurrent_tree<Type>::erase( iterator itr ) {
+		std::lock_guard<std::mutex> lock( erase_lock );
+
+		concurrent_node *node = itr.current_node;
+		concurrent_node *par = node->parent;
+
+		assert( par != 0 );
+
+		uintptr_t link = node->next_link.fetch_or( sealed );
+		concurrent_node *previous = node->previous_sibling;
+		concurrent_node *next = node_of( link );
+
+		if ( previous == 0 ) {
+			par->children_head.store( next );
+		} else {
+			previous->next_link.store( reinterpret_cast<uintptr_t>( next ) );
+		}
+
+		if ( next == 0 ) {
+			par->children_tail.compare_exchange_strong( node, previous );
+			node = itr.current_node;
+		} else {
+			next->previous_sibling = previous;
+		}
+
+		int removed = node->size.load( std::memory_order_relaxed );
+
+		par->degree.fetch_sub( 1, std::memory_order_relaxed );
+
+		for ( concurrent_node *regress = par; regress != 0; regress = regress->parent ) {
+			regress->size.fetch_sub( removed, std::memory_order_relaxed );
+		}
+
+		for ( concurrent_node *regress = par; regress != 0; regress = regress->parent ) {
+			int h = 0;
+
+			for ( concurrent_node *child = regress->children_head.load(); child != 0; child = child->next_sibling() ) {
+				h = std::max( h, child->height.load() + 1 );
+			}
+
+			int old = regress->height.load();
+
+			if ( h >= old ) {
+				raise_height( regress, h );
+				break;
+			}
+
+			if ( !regress->height.compare_exchange_strong( old, h ) ) {
+				// Only appenders change the height concurrently:  it was raised
+				break;
+			}
+
+			int check = 0;
+
+			for ( concurrent_node *child = regress->children_head.load(); child != 0; child = child->next_sibling() ) {
+				check = std::max( check, child->height.load() + 1 );
+			}
+
+			if ( check > h ) {
+				raise_height( regress, check );
+			}
+		}
+
+		// A guard which announces a later epoch read that epoch after
+		// this increment and so cannot reach the unlinked subtree
+		retired_subtree entry = { node, global_epoch.fetch_add( 1 ), false };
+		retired_list.push_back( entry );
+
+		reclaim_retired();
+
+		return removed;
+	}
+
+	/*
+	 * Reclaim
+	 *   int Concurrent_tree<Type> :: reclaim()
+	 *
+	 * Processes each retired subtree whose epoch is less than
+	 * that of every active read guard and returns the number
+	 * of subtrees deleted.
+	 *
+	 * When a subtree is first processed, no guard from before
+	 * it was unlinked remains, so the tail hint of its former
+	 * parent can no longer be moved to it.  If the hint refers
+	 * to it, the hint is moved to the last child;  either way,
+	 * the subtree is retired again in a new epoch, as a guard
+	 * which read the hint may still use it.  When a subtree is
+	 * processed for the second time, it is deleted.  Its former
+	 * parent is not deleted before it is first processed, as
+	 * that was retired in a later epoch.
+	 *
+	 * The active guards are found again for the second time,
+	 * so reclaim() makes two passes:  without active guards,
+	 * all retired subtrees are deleted.
+	 *
+	 * O(max_readers + r + the sizes of the deleted subtrees)
+	 * where r is the number of retired subtrees
+	 */
+
+	template <typename Type>
+	int Concurrent_tree<Type>::reclaim() {
+		std::lock_guard<std::mutex> lock( erase_lock );
+
+		int count = reclaim_retired();
+
+		return count + reclaim_retired();
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::reclaim_retired() {
+		if ( retired_list.empty() ) {
+			return 0;
+		}
+
+		unsigned long oldest = ULONG_MAX;
+
+		for ( std::size_t k = 0; k < slots.size(); ++k ) {
+			unsigned long e = slots[k].epoch.load();
+
+			if ( e != 0 ) {
+				oldest = std::min( oldest, e );
+			}
+		}
+
+		std::size_t n = retired_list.size();
+		std::size_t kept = 0;
+		int count = 0;
+		unsigned long again = 0;
+
+		// Subtrees retired again are appended after the first n
+		for ( std::size_t k = 0; k < n; ++k ) {
+			retired_subtree entry = retired_list[k];
+
+			if ( entry.epoch >= oldest ) {
+				retired_list[kept++] = entry;
+			} else if ( entry.detached ) {
+				destroy( entry.node );
+				++count;
+			} else {
+				concurrent_node *par = entry.node->parent;
+				concurrent_node *hint = entry.node;
+
+				par->children_tail.compare_exchange_strong( hint, last_child( par ) );
+
+				if ( again == 0 ) {
+					again = global_epoch.fetch_add( 1 );
+				}
+
+				entry.epoch = again;
+				entry.detached = true;
+				retired_list.push_back( entry );
+			}
+		}
+
+		retired_list.erase( retired_list.begin() + kept, retired_list.begin() + n );
+
+		return count;
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::retired() const {
+		return static_cast<int>( retired_list.size() );
+	}
+
+	/*
+	 * Last Child
+	 *   concurrent_node *Concurrent_tree<Type> :: last_child( concurrent_node *par )
+	 *
+	 * Returns the last child of the node found by following
+	 * the next sibling links from the head, or 0 if there is
+	 * none.  The caller must hold a read guard or the erase
+	 * lock.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::concurrent_node *Concurrent_tree<Type>::last_child( concurrent_node *par ) {
+		concurrent_node *end = par->children_head.load();
+
+		if ( end != 0 ) {
+			for ( concurrent_node *next = end->next_sibling(); next != 0; next = next->next_sibling() ) {
+				end = next;
+			}
+		}
+
+		return end;
+	}
+
+	/*
+	 * Raise the Height
+	 *   void Concurrent_tree<Type> :: raise_height( concurrent_node *node, int h )
+	 *
+	 * Raises the height of the node to at least h, and that
+	 * of its parent to at least h + 1, and so on, using
+	 * compare-and-swap, until one is already high enough.
+	 *
+	 * O(depth)
+	 */
+
+	template <typename Type>
+	void Concurrent_tree<Type>::raise_height( concurrent_node *node, int h ) {
+		for ( ; node != 0; node = node->parent, ++h ) {
+			int old = node->height.load();
+
+			// A failed compare-and-swap reloads the current height
+			do {
+				if ( old >= h ) {
+					return;
+				}
+			} while ( !node->height.compare_exchange_weak( old, h ) );
+		}
+	}
+
+	/*
+	 * Destroy
+	 *   void Concurrent_tree<Type> :: destroy( concurrent_node *node )
+	 *
+	 * Deletes all nodes in the subtree of the node using an
+	 * explicit stack;  the links of each node are read
+	 * before it is deleted.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type>
+	void Concurrent_tree<Type>::destroy( concurrent_node *node ) {
+		std::vector<concurrent_node *> stack( 1, node );
+
+		while ( !stack.empty() ) {
+			concurrent_node *victim = stack.back();
+			stack.pop_back();
+
+			for ( concurrent_node *child = victim->children_head.load( std::memory_order_relaxed ); child != 0;
+			      child = child->next_sibling() ) {
+				stack.push_back( child );
+			}
+
+			delete victim;
+		}
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *            Read Guard Definitions            * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Constructor
+	 *   Concurrent_tree<Type>::read_guard :: read_guard( Concurrent_tree const &tree )
+	 *
+	 * Claims an idle slot by exchanging 0 for the current
+	 * epoch, and then re-reads the epoch until the announced
+	 * value is still current:  the writer either sees this
+	 * epoch when it reclaims or had advanced the epoch before
+	 * the announcement, in which case any subtree it retired
+	 * was unlinked before the epoch was read.
+	 *
+	 * O(1) unless all slots are in use
+	 */
+
+	template <typename Type>
+	Concurrent_tree<Type>::read_guard::read_guard( Concurrent_tree const &tree ):
+	slot( 0 ) {
+		std::size_t n = tree.slots.size();
+		std::size_t k = std::hash<std::thread::id>()( std::this_thread::get_id() ) % n;
+		unsigned long e = tree.global_epoch.load();
+
+		while ( true ) {
+			unsigned long idle = 0;
+
+			if ( tree.slots[k].epoch.compare_exchange_strong( idle, e ) ) {
+				break;
+			}
+
+			if ( ++k == n ) {
+				k = 0;
+				std::this_thread::yield();
+				e = tree.global_epoch.load();
+			}
+		}
+
+		slot = &tree.slots[k].epoch;
+
+		for ( unsigned long current = tree.global_epoch.load(); current != e; current = tree.global_epoch.load() ) {
+			e = current;
+			slot->store( e );
+		}
+	}
+
+	template <typename Type>
+	Concurrent_tree<Type>::read_guard::~read_guard() {
+		slot->store( 0, std::memory_order_release );
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *             Iterator Definitions             * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Concurrent_tree<Type>::iterator::iterator():
+	current_node( 0 ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Concurrent_tree<Type>::iterator::iterator( concurrent_node *node ):
+	current_node( node ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::iterator::degree() const {
+		return current_node->degree.load( std::memory_order_relaxed );
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::iterator::depth() const {
+		return current_node->node_depth;
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::iterator::height() const {
+		return current_node->height.load( std::memory_order_relaxed );
+	}
+
+	template <typename Type>
+	int Concurrent_tree<Type>::iterator::size() const {
+		return current_node->size.load( std::memory_order_relaxed );
+	}
+
+	template <typename Type>
+	bool Concurrent_tree<Type>::iterator::leaf() const {
+		return current_node->children_head.load( std::memory_order_acquire ) == 0;
+	}
+
+	template <typename Type>
+	bool Concurrent_tree<Type>::iterator::root() const {
+		return current_node->parent == 0;
+	}
+
+	template <typename Type>
+	Type const &Concurrent_tree<Type>::iterator::operator*() const {
+		return current_node->element;
+	}
+
+	/*
+	 * Increment
+	 *   iterator &Concurrent_tree<Type>::iterator :: operator++()
+	 *
+	 * Moves to the next sibling with an acquire load, so
+	 * that a newly appended sibling is fully constructed.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator &Concurrent_tree<Type>::iterator::operator++() {
+		current_node = current_node->next_sibling();
+
+		return *this;
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator Concurrent_tree<Type>::iterator::operator++( int ) {
+		iterator copy = *this;
+		++( *this );
+
+		return copy;
+	}
+
+	template <typename Type>
+	bool Concurrent_tree<Type>::iterator::operator==( iterator const &rhs ) const {
+		return current_node == rhs.current_node;
+	}
+
+	template <typename Type>
+	bool Concurrent_tree<Type>::iterator::operator!=( iterator const &rhs ) const {
+		return current_node != rhs.current_node;
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator Concurrent_tree<Type>::iterator::parent() const {
+		return iterator( current_node->parent );
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator Concurrent_tree<Type>::iterator::begin() const {
+		return iterator( current_node->children_head.load( std::memory_order_acquire ) );
+	}
+
+	template <typename Type>
+	typename Concurrent_tree<Type>::iterator Concurrent_tree<Type>::iterator::end() const {
+		return iterator( 0 );
+	}
+}
+
+#endif
@@ -0,0 +1,837 @@
+#ifndef DATA_STRUCTURES_JOURNALED_TREE
+#define DATA_STRUCTURES_JOURNALED_TREE
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "arvores-gerais.hpp"
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *                 Journal Files                * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Journal Checksum
+	 *   uint32_t journal_checksum( void const *data, std::size_t n, uint32_t seed )
+	 *
+	 * Returns the 32-bit FNV-1a hash of the n bytes at data
+	 * continuing from the hash seed, which is used to detect
+	 * torn and corrupt records.
+	 *
+	 * O(n)
+	 */
+
+	inline uint32_t journal_checksum( void const *data, std::size_t n, uint32_t seed = 2166136261u ) {
+		unsigned char const *bytes = static_cast<unsigned char const *>( data );
+
+		for ( std::size_t i = 0; i < n; ++i ) {
+			seed = ( seed ^ bytes[i] ) * 16777619u;
+		}
+
+		return seed;
+	}
+
+	/*
+	 * Synchronize
+	 *   bool journal_sync( std::FILE *file )
+	 *   bool journal_sync_directory( std::string const &path )
+	 *
+	 * Flush the buffer of the file and wait until its contents
+	 * are on the storage device, or wait until the entries of
+	 * the directory containing the file named by path are, so
+	 * that a rename is durable.  Without POSIX, only the buffer
+	 * is flushed.  Each returns false on an error.
+	 */
+
+	inline bool journal_sync( std::FILE *file ) {
+		if ( std::fflush( file ) != 0 ) {
+			return false;
+		}
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+		return ( fsync( fileno( file ) ) == 0 );
+#else
+		return true;
+#endif
+	}
+
+	inline bool journal_sync_directory( std::string const &path ) {
+#if defined( __unix__ ) || defined( __APPLE__ )
+		std::string::size_type slash = path.rfind( '/' );
+		std::string directory = ( slash == std::string::npos ) ? std::string( "." ) : path.substr( 0, slash + 1 );
+
+		int descriptor = open( directory.c_str(), O_RDONLY );
+
+		if ( descriptor < 0 ) {
+			return false;
+		}
+
+		bool synced = ( fsync( descriptor ) == 0 );
+		close( descriptor );
+
+		return synced;
+#else
+		(void) path;
+		return true;
+#endif
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *                Journaled Tree                * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Journaled Tree Class
+	 *   class Journaled_tree<Tree>
+	 *
+	 * A wrapper around a general tree which makes its edits
+	 * durable by appending a fixed-size binary record for
+	 * each insert(), erase() and update() to a journal file,
+	 * so that the whole tree need not be saved after every
+	 * change.  The objects must be trivially copyable.
+	 *
+	 * A record stores its sort, a sequence number, the
+	 * identifiers of the node and its parent, the object and
+	 * a checksum.  The identifier of a node is its address,
+	 * so that no table of identifiers is kept while editing;
+	 * an address is only reused after the erasure of the node
+	 * has been recorded.  If the nodes are moved, e.g., by
+	 * compact(), the generation of the tree changes and a
+	 * checkpoint is taken before the next edit is recorded,
+	 * so that the journal only refers to the new addresses.
+	 *
+	 * The records are buffered and written in batches (group
+	 * commit):  sync() writes the buffer and waits for the
+	 * device, and is called whenever the buffer holds batch
+	 * records.  A crash loses at most the edits
+	 * made since the last sync().  As each sync() waits for
+	 * the device, larger batches make each edit cheaper but
+	 * may lose more edits.
+	 *
+	 * A snapshot file (the journal path followed by .snapshot)
+	 * stores the whole tree in pre-order.  A checkpoint writes
+	 * a new snapshot to a temporary file, waits for it, renames
+	 * it over the old one and then empties the journal;  the
+	 * snapshot records the last sequence number it contains,
+	 * so if the crash happens before the journal is emptied,
+	 * the records already in the snapshot are skipped.  The
+	 * journal is checkpointed by sync() once it holds as many
+	 * records as the tree has nodes (and at least 4096), so
+	 * replaying it costs no more than loading the snapshot.
+	 *
+	 * The constructor loads the snapshot and replays the
+	 * journal into the tree, stopping at the first torn or
+	 * corrupt record.  A record with a valid checksum which
+	 * cannot be applied is an error, as the edits after it
+	 * would be lost.  The nodes are linked without updating
+	 * any metadata, which is then computed once for the whole
+	 * tree by rebuild_metadata().  As the nodes now have new
+	 * addresses, a checkpoint is then taken.  If no snapshot
+	 * exists, the tree as given is the first snapshot.
+	 *
+	 * While the wrapper exists, the tree may only be modified
+	 * through it.  good() is false once a file could not be
+	 * read or written;  the edits must then not be used, as
+	 * they could not be recorded:  they assert this and, if
+	 * assertions are disabled, leave the tree unchanged and
+	 * return end(), 0 or false, respectively.
+	 ****************************************************/
+
+	template <typename Tree>
+	class Journaled_tree {
+		public:
+			typedef typename Tree::iterator iterator;
+			typedef typename Tree::iterator::value_type value_type;
+
+			Journaled_tree( Tree &, std::string const &path, int batch = 4096 );
+			~Journaled_tree();
+
+			bool good() const;
+			int replayed() const;
+			int pending() const;
+
+			iterator insert( iterator parent, value_type const &obj );
+			int erase( iterator itr );
+			bool update( iterator itr, value_type const &obj );
+
+			bool sync();
+			bool checkpoint();
+
+		private:
+			typedef typename Tree::tree_node tree_node;
+			typedef std::unordered_map<uint64_t, tree_node *> node_table;
+			typedef std::unordered_map<tree_node const *, uint64_t> id_table;
+
+			static uint64_t const snapshot_magic = 0x31544F4853504E53ull;
+			static uint64_t const checkpoint_minimum = 4096;
+
+			enum record_kind { inserted = 1, erased, updated };
+
+			struct journal_record {
+				uint32_t kind;
+				uint32_t checksum;
+				uint64_t sequence;
+				uint64_t node;
+				uint64_t parent;
+				value_type element;
+			};
+
+			struct snapshot_header {
+				uint64_t magic;
+				uint64_t sequence;
+				uint64_t count;
+			};
+
+			struct snapshot_node {
+				uint64_t id;
+				uint64_t degree;
+				value_type element;
+			};
+
+			Tree *tree;
+			std::string journal_path;
+			std::string snapshot_path;
+			std::FILE *journal;
+			std::vector<journal_record> buffer;
+			std::size_t batch_size;
+			uint64_t node_count;
+			uint64_t sequence;
+			uint64_t journaled;
+			unsigned long known_generation;
+			int replay_count;
+			bool healthy;
+
+			static uint64_t identifier( tree_node const * );
+
+			void follow();
+			void append( record_kind, uint64_t node, uint64_t parent, value_type const * );
+			bool load_snapshot( std::FILE *, node_table &, id_table & );
+			bool replay_journal( node_table &, id_table & );
+			int discard( tree_node *, node_table *, id_table * );
+
+			Journaled_tree( Journaled_tree const & );
+			Journaled_tree &operator=( Journaled_tree const & );
+	};
+
+	/*
+	 * Constructor
+	 *   Journaled_tree<Tree> :: Journaled_tree( Tree &t, std::string const &path, int batch )
+	 *
+	 * Creates a wrapper around the tree which journals to the
+	 * file path and writes a batch after the given number of
+	 * records.  If the snapshot exists, the tree is replaced
+	 * by the snapshot and the journal is replayed up to the
+	 * first torn or corrupt record;  the rest of the journal
+	 * is ignored.  A checkpoint is then taken.  If the snapshot
+	 * is short or corrupt, the tree and the files are left
+	 * unchanged and good() is false.  If a valid record cannot
+	 * be applied, the tree holds the snapshot and the records
+	 * before it, the files are left unchanged and good() is
+	 * false.  Otherwise, the tree is written as the first
+	 * snapshot.
+	 *
+	 * O(n + r) where r is the number of records in the journal
+	 */
+
+	template <typename Tree>
+	Journaled_tree<Tree>::Journaled_tree( Tree &t, std::string const &path, int batch ):
+	tree( &t ),
+	journal_path( path ),
+	snapshot_path( path + ".snapshot" ),
+	journal( 0 ),
+	buffer(),
+	batch_size( batch < 1 ? 1 : batch ),
+	node_count( 0 ),
+	sequence( 0 ),
+	journaled( 0 ),
+	known_generation( 0 ),
+	replay_count( 0 ),
+	healthy( true ) {
+		static_assert( std::is_trivially_copyable<value_type>::value,
+		               "Journaled_tree requires trivially copyable objects" );
+
+		buffer.reserve( batch_size );
+
+		std::FILE *file = std::fopen( snapshot_path.c_str(), "rb" );
+
+		if ( file == 0 ) {
+			node_count = tree->size();
+			checkpoint();
+			return;
+		}
+
+		node_table nodes;
+		id_table ids;
+
+		bool loaded = load_snapshot( file, nodes, ids );
+		std::fclose( file );
+
+		if ( !loaded ) {
+			// Leave the tree and both files as they are
+			healthy = false;
+			return;
+		}
+
+		bool replayed = replay_journal( nodes, ids );
+		tree->rebuild_metadata();
+		++tree->structure_generation;
+		++tree->removal_generation;
+
+		if ( !replayed ) {
+			// Keep the journal, which holds the edits after the record
+			healthy = false;
+			return;
+		}
+
+		checkpoint();
+	}
+
+	/*
+	 * Destructor
+	 *   Journaled_tree<Tree> :: ~Journaled_tree()
+	 *
+	 * Writes the buffered records and closes the journal.
+	 */
+
+	template <typename Tree>
+	Journaled_tree<Tree>::~Journaled_tree() {
+		if ( journal != 0 ) {
+			sync();
+			std::fclose( journal );
+		}
+	}
+
+	template <typename Tree>
+	bool Journaled_tree<Tree>::good() const {
+		return healthy;
+	}
+
+	template <typename Tree>
+	int Journaled_tree<Tree>::replayed() const {
+		return replay_count;
+	}
+
+	template <typename Tree>
+	int Journaled_tree<Tree>::pending() const {
+		return static_cast<int>( buffer.size() );
+	}
+
+	/*
+	 * Insert
+	 *   iterator Journaled_tree<Tree> :: insert( iterator parent, Type const &obj )
+	 *
+	 * Appends a new child storing the object to the node
+	 * referred to by parent, records it, and returns an
+	 * iterator referring to it.
+	 *
+	 * O(depth) amortized
+	 */
+
+	template <typename Tree>
+	typename Journaled_tree<Tree>::iterator Journaled_tree<Tree>::insert( iterator parent, value_type const &obj ) {
+		assert( healthy );
+
+		follow();
+
+		if ( !healthy ) {
+			return tree->end();
+		}
+
+		tree_node *par = parent.current_node;
+
+		parent.insert( obj );
+		++node_count;
+
+		append( inserted, identifier( par->children_tail ), identifier( par ), &obj );
+
+		return iterator( par->children_tail, par );
+	}
+
+	/*
+	 * Erase
+	 *   int Journaled_tree<Tree> :: erase( iterator itr )
+	 *
+	 * Removes the subtree defined by the node referred to by
+	 * itr (which must not be the root), records it, and returns
+	 * the number of nodes removed.  The metadata of the
+	 * ancestors is recomputed from their children.
+	 *
+	 * O(size of the subtree + sum of the degrees of the ancestors)
+	 */
+
+	template <typename Tree>
+	int Journaled_tree<Tree>::erase( iterator itr ) {
+		tree_node *node = itr.current_node;
+		tree_node *par = node->parent;
+		uint64_t id = identifier( node );
+
+		assert( par != 0 );
+		assert( healthy );
+
+		follow();
+
+		if ( !healthy ) {
+			return 0;
+		}
+
+		par->unlink_child( node );
+
+		for ( tree_node *regress = par; regress != 0; regress = regress->parent ) {
+			regress->recompute();
+		}
+
+		int removed = discard( node, 0, 0 );
+		node_count -= removed;
+		++tree->structure_generation;
+		++tree->removal_generation;
+		known_generation = tree->structure_generation;
+
+		// The record is appended once the edit is complete, as
+		// appending it may take a checkpoint
+		append( erased, id, 0, 0 );
+
+		return removed;
+	}
+
+	/*
+	 * Update
+	 *   bool Journaled_tree<Tree> :: update( iterator itr, Type const &obj )
+	 *
+	 * Replaces the object stored in the node referred to by
+	 * itr, records it and returns true.
+	 *
+	 * O(1) amortized, plus the cost of iterator::update()
+	 */
+
+	template <typename Tree>
+	bool Journaled_tree<Tree>::update( iterator itr, value_type const &obj ) {
+		assert( healthy );
+
+		follow();
+
+		if ( !healthy ) {
+			return false;
+		}
+
+		itr.update( obj );
+
+		append( updated, identifier( itr.current_node ), 0, &obj );
+
+		return true;
+	}
+
+	/*
+	 * Sync
+	 *   bool Journaled_tree<Tree> :: sync()
+	 *
+	 * Writes the buffered records to the journal with one call
+	 * and waits until they are on the storage device.  Takes a
+	 * checkpoint if the journal holds as many records as the
+	 * tree has nodes.  Returns false on an error.
+	 *
+	 * O(b) where b is the number of buffered records, or O(n)
+	 * if a checkpoint is taken
+	 */
+
+	template <typename Tree>
+	bool Journaled_tree<Tree>::sync() {
+		if ( journal == 0 ) {
+			buffer.clear();
+			return false;
+		}
+
+		if ( !buffer.empty() ) {
+			bool written = ( std::fwrite( buffer.data(), sizeof( journal_record ), buffer.size(), journal ) == buffer.size() );
+
+			journaled += buffer.size();
+			buffer.clear();
+
+			if ( !journal_sync( journal ) || !written ) {
+				healthy = false;
+				return false;
+			}
+		}
+
+		if ( journaled >= checkpoint_minimum && journaled >= node_count ) {
+			return checkpoint();
+		}
+
+		return healthy;
+	}
+
+	/*
+	 * Checkpoint
+	 *   bool Journaled_tree<Tree> :: checkpoint()
+	 *
+	 * Writes every node of the tree in pre-order, with its
+	 * identifier, degree and object, to a temporary file which
+	 * is renamed over the snapshot once it is on the storage
+	 * device, and then empties the journal.  The buffered
+	 * records are contained in the snapshot and are dropped.
+	 * Returns false on an error, in which case the old snapshot
+	 * and journal are unchanged.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Tree>
+	bool Journaled_tree<Tree>::checkpoint() {
+		known_generation = tree->structure_generation;
+
+		std::string temporary = snapshot_path + ".tmp";
+		std::FILE *file = std::fopen( temporary.c_str(), "wb" );
+
+		if ( file == 0 ) {
+			healthy = false;
+			return false;
+		}
+
+		snapshot_header header = { snapshot_magic, sequence, node_count };
+		uint32_t checksum = journal_checksum( &header, sizeof( header ) );
+		bool written = ( std::fwrite( &header, sizeof( header ), 1, file ) == 1 );
+
+		std::vector<tree_node *> stack( 1, tree->root_node );
+		snapshot_node entry;
+
+		while ( written && !stack.empty() ) {
+			tree_node *node = stack.back();
+			stack.pop_back();
+
+			std::memset( &entry, 0, sizeof( entry ) );
+			entry.id = identifier( node );
+			std::memcpy( &entry.element, &node->element, sizeof( value_type ) );
+
+			// Push the children from the last so that the first is popped first
+			for ( tree_node *child = node->children_tail; child != 0; child = child->previous_sibling ) {
+				stack.push_back( child );
+				++entry.degree;
+			}
+
+			checksum = journal_checksum( &entry, sizeof( entry ), checksum );
+			written = ( std::fwrite( &entry, sizeof( entry ), 1, file ) == 1 );
+		}
+
+		written = written && ( std::fwrite( &checksum, sizeof( checksum ), 1, file ) == 1 );
+		written = journal_sync( file ) && written;
+		std::fclose( file );
+
+		if ( !written || std::rename( temporary.c_str(), snapshot_path.c_str() ) != 0 ) {
+			std::remove( temporary.c_str() );
+			healthy = false;
+			return false;
+		}
+
+		journal_sync_directory( snapshot_path );
+
+		if ( journal != 0 ) {
+			std::fclose( journal );
+		}
+
+		journal = std::fopen( journal_path.c_str(), "wb" );
+		buffer.clear();
+		journaled = 0;
+		healthy = ( journal != 0 );
+
+		return healthy;
+	}
+
+	template <typename Tree>
+	uint64_t Journaled_tree<Tree>::identifier( tree_node const *node ) {
+		return static_cast<uint64_t>( reinterpret_cast<uintptr_t>( node ) );
+	}
+
+	/*
+	 * Follow the Tree
+	 *   void Journaled_tree<Tree> :: follow()
+	 *
+	 * Takes a checkpoint if the tree was changed other than
+	 * through the wrapper since the last checkpoint or edit,
+	 * e.g., if compact() moved its nodes:  the identifiers of
+	 * the nodes in the snapshot and the journal would no longer
+	 * match their addresses.
+	 *
+	 * O(1), or O(n) if a checkpoint is taken
+	 */
+
+	template <typename Tree>
+	void Journaled_tree<Tree>::follow() {
+		if ( healthy && tree->structure_generation != known_generation ) {
+			checkpoint();
+		}
+	}
+
+	/*
+	 * Append a Record
+	 *   void Journaled_tree<Tree> :: append( record_kind kind, uint64_t node, uint64_t parent, Type const *obj )
+	 *
+	 * Buffers a record with the next sequence number and the
+	 * object (if any), computing its checksum over all its
+	 * bytes with the checksum field zero, and writes the batch
+	 * once it is full.
+	 *
+	 * O(1) amortized
+	 */
+
+	template <typename Tree>
+	void Journaled_tree<Tree>::append( record_kind kind, uint64_t node, uint64_t parent, value_type const *obj ) {
+		journal_record entry;
+
+		std::memset( &entry, 0, sizeof( entry ) );
+		entry.kind = kind;
+		entry.sequence = ++sequence;
+		entry.node = node;
+		entry.parent = parent;
+
+		if ( obj != 0 ) {
+			std::memcpy( &entry.element, obj, sizeof( value_type ) );
+		}
+
+		entry.checksum = journal_checksum( &entry, sizeof( entry ) );
+		buffer.push_back( entry );
+
+		if ( buffer.size() >= batch_size ) {
+			sync();
+		}
+	}
+
+	/*
+	 * Load the Snapshot
+	 *   bool Journaled_tree<Tree> :: load_snapshot( std::FILE *file, node_table &nodes, id_table &ids )
+	 *
+	 * Reads every node of the snapshot into a vector and checks
+	 * that the degrees describe a single tree and that the
+	 * checksum matches;  if not, false is returned and neither
+	 * the tree nor the tables are changed.
+	 *
+	 * Otherwise, all nodes of the tree except the root are
+	 * removed, the first node is stored in the root and each
+	 * other node is appended to the nearest node above it on a
+	 * stack which still lacks children.  The nodes are entered
+	 * in both tables by their former identifiers, and no
+	 * metadata is updated.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Tree>
+	bool Journaled_tree<Tree>::load_snapshot( std::FILE *file, node_table &nodes, id_table &ids ) {
+		snapshot_header header;
+
+		if ( std::fread( &header, sizeof( header ), 1, file ) != 1 || header.magic != snapshot_magic || header.count == 0 ) {
+			return false;
+		}
+
+		uint32_t checksum = journal_checksum( &header, sizeof( header ) );
+		std::vector<snapshot_node> entries;
+		std::vector<uint64_t> missing;
+		snapshot_node entry;
+
+		// The count is not trusted until the checksum matches, so
+		// the vector grows as the nodes are read
+		for ( uint64_t k = 0; k < header.count; ++k ) {
+			if ( std::fread( &entry, sizeof( entry ), 1, file ) != 1 ) {
+				return false;
+			}
+
+			checksum = journal_checksum( &entry, sizeof( entry ), checksum );
+
+			while ( !missing.empty() && missing.back() == 0 ) {
+				missing.pop_back();
+			}
+
+			// Every node but the first must be the child of a node
+			// on the stack, and the first must begin the tree
+			if ( missing.empty() != ( k == 0 ) ) {
+				return false;
+			}
+
+			if ( k != 0 ) {
+				--missing.back();
+			}
+
+			if ( entry.degree > 0 ) {
+				missing.push_back( entry.degree );
+			}
+
+			entries.push_back( entry );
+		}
+
+		while ( !missing.empty() && missing.back() == 0 ) {
+			missing.pop_back();
+		}
+
+		uint32_t stored;
+
+		if ( !missing.empty() || std::fread( &stored, sizeof( stored ), 1, file ) != 1 || stored != checksum ) {
+			return false;
+		}
+
+		tree->clear();
+
+		std::vector<std::pair<tree_node *, uint64_t> > stack;
+
+		nodes.reserve( entries.size() );
+		ids.reserve( entries.size() );
+
+		for ( std::size_t k = 0; k < entries.size(); ++k ) {
+			tree_node *node = tree->root_node;
+
+			if ( k == 0 ) {
+				node->element = entries[k].element;
+			} else {
+				while ( stack.back().second == 0 ) {
+					stack.pop_back();
+				}
+
+				--stack.back().second;
+				node = new tree_node( entries[k].element, stack.back().first, 0, 0, 0 );
+				stack.back().first->append_child( node );
+			}
+
+			nodes[entries[k].id] = node;
+			ids[node] = entries[k].id;
+
+			if ( entries[k].degree > 0 ) {
+				stack.push_back( std::make_pair( node, entries[k].degree ) );
+			}
+		}
+
+		sequence = header.sequence;
+		node_count = header.count;
+
+		return true;
+	}
+
+	/*
+	 * Replay the Journal
+	 *   bool Journaled_tree<Tree> :: replay_journal( node_table &nodes, id_table &ids )
+	 *
+	 * Applies each record of the journal which follows the
+	 * snapshot, in order, linking and unlinking nodes without
+	 * updating any metadata.  Records already contained in
+	 * the snapshot are skipped.  The replay stops at the
+	 * first partial record or record with an invalid checksum,
+	 * which is the torn end of the journal.  Returns false if
+	 * a record with a valid checksum has an unexpected sequence
+	 * number, sort or node, as it cannot be applied.
+	 *
+	 * O(r + sizes of the erased subtrees)
+	 */
+
+	template <typename Tree>
+	bool Journaled_tree<Tree>::replay_journal( node_table &nodes, id_table &ids ) {
+		std::FILE *file = std::fopen( journal_path.c_str(), "rb" );
+
+		if ( file == 0 ) {
+			return true;
+		}
+
+		journal_record entry;
+		bool applied = true;
+
+		while ( std::fread( &entry, sizeof( entry ), 1, file ) == 1 ) {
+			uint32_t stored = entry.checksum;
+			entry.checksum = 0;
+
+			if ( journal_checksum( &entry, sizeof( entry ) ) != stored ) {
+				break;
+			}
+
+			if ( entry.sequence <= sequence ) {
+				continue;
+			}
+
+			typename node_table::iterator found = nodes.find( entry.kind == inserted ? entry.parent : entry.node );
+
+			if ( entry.sequence != sequence + 1 || found == nodes.end() ) {
+				applied = false;
+				break;
+			}
+
+			tree_node *node = found->second;
+
+			if ( entry.kind == inserted ) {
+				tree_node *child = new tree_node( entry.element, node, 0, 0, 0 );
+				node->append_child( child );
+
+				nodes[entry.node] = child;
+				ids[child] = entry.node;
+				++node_count;
+			} else if ( entry.kind == erased && node->parent != 0 ) {
+				node->parent->unlink_child( node );
+				node_count -= discard( node, &nodes, &ids );
+			} else if ( entry.kind == updated ) {
+				node->element = entry.element;
+			} else {
+				applied = false;
+				break;
+			}
+
+			sequence = entry.sequence;
+			++replay_count;
+		}
+
+		std::fclose( file );
+
+		return applied;
+	}
+
+	/*
+	 * Discard
+	 *   int Journaled_tree<Tree> :: discard( tree_node *node, node_table *nodes, id_table *ids )
+	 *
+	 * Deletes every node in the subtree of the node using an
+	 * explicit stack, removing the nodes from the tables (if
+	 * any), and returns the number of nodes deleted.
+	 *
+	 * O(size of the subtree)
+	 */
+
+	template <typename Tree>
+	int Journaled_tree<Tree>::discard( tree_node *node, node_table *nodes, id_table *ids ) {
+		std::vector<tree_node *> doomed( 1, node );
+		int count = 0;
+
+		while ( !doomed.empty() ) {
+			tree_node *victim = doomed.back();
+			doomed.pop_back();
+
+			for ( tree_node *child = victim->children_head; child != 0; child = child->next_sibling ) {
+				doomed.push_back( child );
+			}
+
+			if ( ids != 0 ) {
+				typename id_table::iterator found = ids->find( victim );
+
+				nodes->erase( found->second );
+				ids->erase( found );
+			}
+
+			victim->destroy();
+			++count;
+		}
+
+		return count;
+	}
+}
+
+#endif
@@ -1,612 +1,3518 @@
 #ifndef CA_UWATERLOO_ALUMNI_DWHARDER_GENERAL_TREE
 #define CA_UWATERLOO_ALUMNI_DWHARDER_GENERAL_TREE
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <climits>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
 
 // Author:  Douglas Wilhelm Harder
 // Copyright (c) 2009 by Douglas Wilhelm Harder.  All rights reserved.
 // Under construction....
 
+// The breadth-first iterator over linked children prefetches
+// the node this many entries ahead of the next node to be
+// visited in its queue;  0 disables prefetching.  See bench.cpp
+// ("make bench") for the measurements.
+#ifndef GENERAL_TREE_PREFETCH_DISTANCE
+#define GENERAL_TREE_PREFETCH_DISTANCE 4
+#endif
+
+#if defined( __GNUC__ ) && GENERAL_TREE_PREFETCH_DISTANCE > 0
+#define GENERAL_TREE_PREFETCH( ptr ) __builtin_prefetch( ptr )
+#else
+#define GENERAL_TREE_PREFETCH( ptr ) ( (void) 0 )
+#endif
+
 namespace Data_structures {
 	/****************************************************
 	 * ************************************************ *
-	 * *                 General Tree                 * *
+	 * *            Tree Metadata Policies            * *
 	 * ************************************************ *
 	 ****************************************************/
 
 	/****************************************************
-	 * General Tree Class
-	 *   class General_tree<Type>
-	 *
-	 * Author: Douglas Wilhelm Harder
-	 * 2009-10-10
+	 * Tree Metadata Policy
+	 *   struct tree_metadata<Degree, Depth, Height, Size, Hash>
 	 *
-	 * A general tree class which attempts to generalize
-	 * the philosophy of the weak ordering used in the
-	 * STL to a hierarchical ordering.  The ordering
-	 * is explicit:  the programmer dictates which
-	 * objects are placed as children to a specific
-	 * object.
+	 * A policy selecting which information is stored in
+	 * each node of a general tree and maintained by the
+	 * operations which modify the tree:
+	 *   - the degree of the node,
+	 *   - the depth of the node,
+	 *   - the height of the subtree defined by the node,
+	 *   - the size of the subtree defined by the node, and
+	 *   - a hash of the subtree defined by the node.
 	 *
-	 * There are very few functions which work on	
-	 * general trees:
-	 *  - a constructor and destructor
-	 *  - empty, height, size, and clear
+	 * Fields which are not selected are not members of the
+	 * tree nodes and their maintenance is compiled out.  They
+	 * may still be queried, in which case they are computed:
+	 *   - the degree in O(degree),
+	 *   - the depth in O(depth), and
+	 *   - the height, size and hash in O(size of the subtree).
 	 *
-	 * All other functionality is moved to the
-	 * iterators, of which there are three sorts:
-	 *    - an explicit iterator where the programmer
-	 *      can traverse either up or down the edges
-	 *      of a tree
+	 * The hash of a subtree combines the hash of the object
+	 * stored in the node with the hashes of its children, in
+	 * order, and its degree.  Equal subtrees have equal hashes;
+	 * it requires std::hash<Type> and is not stored by default.
 	 *
-	 *    - a depth-first traversal iterator which
-	 *      begins at the root node and steps through
-	 *      the nodes in a depth-first traversal	
-	 *      order visiting each node once
+	 * The common policies are:
+	 *   full_metadata     the degree, depth, height and size
+	 *                     are stored (the default)
+	 *   hashed_metadata   all five are stored
+	 *   size_metadata     only the size is stored
+	 *   height_metadata   only the height is stored
+	 *   no_metadata       nothing is stored
+	 ****************************************************/
+
+	template <bool Degree, bool Depth, bool Height, bool Size, bool Hash = false>
+	struct tree_metadata {
+		static bool const degree = Degree;
+		static bool const depth  = Depth;
+		static bool const height = Height;
+		static bool const size   = Size;
+		static bool const hash   = Hash;
+	};
+
+	typedef tree_metadata<true,  true,  true,  true>        full_metadata;
+	typedef tree_metadata<true,  true,  true,  true, true>  hashed_metadata;
+	typedef tree_metadata<false, false, false, true>        size_metadata;
+	typedef tree_metadata<false, false, true,  false>       height_metadata;
+	typedef tree_metadata<false, false, false, false>       no_metadata;
+
+	/****************************************************
+	 * Tree Node Metadata Classes
+	 *   class tree_node_degree<Node, Stored>
+	 *   class tree_node_depth<Node, Stored>
+	 *   class tree_node_height<Node, Stored>
+	 *   class tree_node_size<Node, Stored>
+	 *   class tree_node_hash<Node, Stored>
 	 *
-	 *    - a breadth-first traversal iterator which
-	 *      begins at the root node and steps through
-	 *      the nodes in a breadth-first traversal
-	 *      order visiting each node once
+	 * The base classes of a tree node which either store
+	 * the corresponding field or, if it is not stored,
+	 * are empty and compute the value when it is queried.
+	 * Setting a field which is not stored does nothing.
 	 *
-	 * In order to perform a pre-, post-, or mixed-order 
-	 * traversal, the programmer use the explicit iterator
-	 * together with a stack or queue.
+	 * The template argument Node is the tree node class
+	 * deriving from these classes.
 	 ****************************************************/
 
-	template <typename Type>
-	class General_tree {
+	template <typename Node, bool Stored>
+	class tree_node_degree {
 		public:
-			class iterator;
-			class depth_iterator;
-			class breadth_iterator;
+			int node_degree;
 
-			General_tree( Type const &obj = Type() );
-			~General_tree();
-			bool empty() const;
-			int size() const;
-			int height() const;
+			tree_node_degree():node_degree( 0 ) {}
+			int degree() const { return node_degree; }
+			void set_degree( int n ) { node_degree = n; }
+	};
 
-			void clear();
+	template <typename Node>
+	class tree_node_degree<Node, false> {
+		public:
+			int degree() const;
+			void set_degree( int ) {}
+	};
 
-			iterator begin();
-			iterator end();
+	template <typename Node, bool Stored>
+	class tree_node_depth {
+		public:
+			int node_depth;
 
-			depth_iterator begin_depth();
-			depth_iterator end_depth();
+			tree_node_depth():node_depth( 0 ) {}
+			int depth() const { return node_depth; }
+			void set_depth( int n ) { node_depth = n; }
+	};
 
-			breadth_iterator begin_breadth();
-			breadth_iterator end_breadth();
+	template <typename Node>
+	class tree_node_depth<Node, false> {
+		public:
+			int depth() const;
+			void set_depth( int ) {}
+	};
 
-		private:
-			class tree_node;
-			tree_node *root_node;
+	template <typename Node, bool Stored>
+	class tree_node_height {
+		public:
+			int node_height;
 
-		friend class iterator;
-		friend class depth_iterator;
-		friend class breadth_iterator;
-		friend class tree_node;
+			tree_node_height():node_height( 0 ) {}
+			int height() const { return node_height; }
+			void set_height( int n ) { node_height = n; }
 	};
 
-	/****************************************************
-	 * ************************************************ *
-	 * *                  Tree Node                   * *
-	 * ************************************************ *
-	 ****************************************************/
+	template <typename Node>
+	class tree_node_height<Node, false> {
+		public:
+			int height() const;
+			void set_height( int ) {}
+	};
 
-	/****************************************************
-	 * Tree Node Class
-	 *   class General_tree<Type> :: Tree_node
-	 *
-	 * Author: Douglas Wilhelm Harder
-	 * 2009-10-10
+	template <typename Node, bool Stored>
+	class tree_node_size {
+		public:
+			int node_size;
+
+			tree_node_size():node_size( 1 ) {}
+			int size() const { return node_size; }
+			void set_size( int n ) { node_size = n; }
+	};
+
+	template <typename Node>
+	class tree_node_size<Node, false> {
+		public:
+			int size() const;
+			void set_size( int ) {}
+	};
+
+	/*
+	 * Hash Functions
+	 *   std::size_t hash_mix( std::size_t value )
+	 *   std::size_t hash_element( Type const &obj )
+	 *   std::size_t hash_combine( std::size_t seed, std::size_t value )
 	 *
-	 * A tree node class for representing node stored
-	 * in this general tree.  These nodes contain:
+	 * Scramble the bits of a value, hash an object with
+	 * std::hash and mix a value into a hash so that the order
+	 * of the values matters.
 	 *
-	 * Pointers to:
-	 *   The parent tree node,
-	 *   The next and previous sibling tree nodes, and
-	 *   The head and tail pointers for a doubly linked
-	 *   list of children nodes.
+	 * std::hash is often the identity on integers, so both the
+	 * hash of an object and each combined hash are passed through
+	 * the 64-bit finalizer of MurmurHash3:  otherwise small
+	 * subtrees such as 1(1) and 2(0) have equal hashes, and
+	 * probably_equal_subtree() and diff() trust equal hashes.
 	 *
-	 * Other information stored includes:
-	 *   The degree, depth, height, and size of the
-	 *   node and the asssociated subtree defined by
-	 *   this node and all its descendants.
-	 ****************************************************/
+	 * O(1)
+	 */
+
+	inline std::size_t hash_mix( std::size_t value ) {
+		unsigned long long x = value;
+
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+
+		return static_cast<std::size_t>( x );
+	}
 
 	template <typename Type>
-	class General_tree<Type>::tree_node {
+	std::size_t hash_element( Type const &obj ) {
+		return hash_mix( std::hash<Type>()( obj ) );
+	}
+
+	inline std::size_t hash_combine( std::size_t seed, std::size_t value ) {
+		return hash_mix( seed ^ ( value + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 ) ) );
+	}
+
+	template <typename Node, bool Stored>
+	class tree_node_hash {
 		public:
-			Type element;
-			tree_node *parent;
-			tree_node *previous_sibling;
-			tree_node *next_sibling;
-			tree_node *children_head;
-			tree_node *children_tail;
+			std::size_t node_hash;
 
-			int node_degree;
-			int node_depth;
-			int node_height;
-			int node_size;
+			template <typename Type>
+			explicit tree_node_hash( Type const &obj ):node_hash( hash_combine( hash_element( obj ), 0 ) ) {}
+			std::size_t hash() const { return node_hash; }
+			void update_hash();
+	};
 
-			tree_node( Type const &, tree_node *, tree_node *, tree_node *, int );
-			void clear();
-			// iterator find( Type const & );
+	template <typename Node>
+	class tree_node_hash<Node, false> {
+		public:
+			template <typename Type>
+			explicit tree_node_hash( Type const & ) {}
+			std::size_t hash() const;
+			void update_hash() {}
 	};
 
+	/*
+	 * Computed Degree
+	 *   int tree_node_degree<Node, false> :: degree() const
+	 *
+	 * Counts the children of the node.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Node>
+	int tree_node_degree<Node, false>::degree() const {
+		int count = 0;
+
+		for ( Node const *child = static_cast<Node const *>( this )->children_head; child != 0; child = child->next_sibling ) {
+			++count;
+		}
+
+		return count;
+	}
+
+	/*
+	 * Computed Depth
+	 *   int tree_node_depth<Node, false> :: depth() const
+	 *
+	 * Counts the strict ancestors of the node.
+	 *
+	 * O(depth)
+	 */
+
+	template <typename Node>
+	int tree_node_depth<Node, false>::depth() const {
+		int count = 0;
+
+		for ( Node const *regress = static_cast<Node const *>( this )->parent; regress != 0; regress = regress->parent ) {
+			++count;
+		}
+
+		return count;
+	}
+
+	/*
+	 * Computed Height
+	 *   int tree_node_height<Node, false> :: height() const
+	 *
+	 * Walks the subtree defined by the node in pre-order using
+	 * the children head, next sibling and parent pointers while
+	 * keeping track of the depth relative to the node.
+	 *
+	 * O(size of the subtree)
+	 */
+
+	template <typename Node>
+	int tree_node_height<Node, false>::height() const {
+		Node const *top = static_cast<Node const *>( this );
+		Node const *ptr = top;
+		int current = 0;
+		int result = 0;
+
+		while ( true ) {
+			if ( ptr->children_head != 0 ) {
+				ptr = ptr->children_head;
+				++current;
+				result = std::max( result, current );
+			} else {
+				while ( ptr != top && ptr->next_sibling == 0 ) {
+					ptr = ptr->parent;
+					--current;
+				}
+
+				if ( ptr == top ) {
+					return result;
+				}
+
+				ptr = ptr->next_sibling;
+			}
+		}
+	}
+
+	/*
+	 * Computed Size
+	 *   int tree_node_size<Node, false> :: size() const
+	 *
+	 * Counts the nodes of the subtree defined by the node
+	 * by walking it in pre-order.
+	 *
+	 * O(size of the subtree)
+	 */
+
+	template <typename Node>
+	int tree_node_size<Node, false>::size() const {
+		Node const *top = static_cast<Node const *>( this );
+		Node const *ptr = top;
+		int result = 1;
+
+		while ( true ) {
+			if ( ptr->children_head != 0 ) {
+				ptr = ptr->children_head;
+				++result;
+			} else {
+				while ( ptr != top && ptr->next_sibling == 0 ) {
+					ptr = ptr->parent;
+				}
+
+				if ( ptr == top ) {
+					return result;
+				}
+
+				ptr = ptr->next_sibling;
+				++result;
+			}
+		}
+	}
+
+	/*
+	 * Update the Hash
+	 *   void tree_node_hash<Node, true> :: update_hash()
+	 *
+	 * Recomputes the hash of the node from its object and
+	 * the (up-to-date) hashes of its children.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Node, bool Stored>
+	void tree_node_hash<Node, Stored>::update_hash() {
+		Node const *node = static_cast<Node const *>( this );
+		std::size_t value = hash_element( node->element );
+		std::size_t count = 0;
+
+		for ( Node const *child = node->children_head; child != 0; child = child->next_sibling ) {
+			value = hash_combine( value, child->node_hash );
+			++count;
+		}
+
+		node_hash = hash_combine( value, count );
+	}
+
+	/*
+	 * Computed Hash
+	 *   std::size_t tree_node_hash<Node, false> :: hash() const
+	 *
+	 * Walks the subtree defined by the node in post-order
+	 * with an explicit stack of partially combined hashes,
+	 * combining each completed child into its parent.
+	 *
+	 * O(size of the subtree)
+	 */
+
+	template <typename Node>
+	std::size_t tree_node_hash<Node, false>::hash() const {
+		struct frame {
+			Node const *next;
+			std::size_t value;
+			std::size_t count;
+		};
+
+		Node const *top = static_cast<Node const *>( this );
+		frame first = { top->children_head, hash_element( top->element ), 0 };
+		std::vector<frame> stack( 1, first );
+
+		while ( true ) {
+			Node const *child = stack.back().next;
+
+			if ( child != 0 ) {
+				stack.back().next = child->next_sibling;
+				frame next = { child->children_head, hash_element( child->element ), 0 };
+				stack.push_back( next );
+			} else {
+				std::size_t value = hash_combine( stack.back().value, stack.back().count );
+				stack.pop_back();
+
+				if ( stack.empty() ) {
+					return value;
+				}
+
+				stack.back().value = hash_combine( stack.back().value, value );
+				++stack.back().count;
+			}
+		}
+	}
+
 	/****************************************************
 	 * ************************************************ *
-	 * *                   Iterator                   * *
+	 * *            Child Storage Policies            * *
 	 * ************************************************ *
 	 ****************************************************/
 
 	/****************************************************
-	 * Iterator Class
-	 *   class General_tree<Type> :: iterator
+	 * Child Storage Policies
+	 *   struct linked_children
+	 *   struct indexed_children<N>
 	 *
-	 * Author: Douglas Wilhelm Harder
-	 * 2009-10-10
+	 * A policy selecting how the children of each node of
+	 * a general tree are stored.
 	 *
-	 * The object stored in the tree node referenced
-	 * by the iterator may be accessed with operator*
+	 * With linked_children (the default), the children are
+	 * only kept in the doubly linked list formed by the
+	 * children head and tail pointers of the parent and the
+	 * previous and next sibling pointers of the children.
+	 * Accessing the kth child is O(k).
 	 *
-	 * The depth and degree of the referenced tree node
-	 * may be retrieved, and
-	 * The status of the tree node as a leaf node may
-	 * also be queried.
+	 * With indexed_children<N>, each node additionally stores
+	 * an array of pointers to its children which holds up to
+	 * N children within the node itself and which is moved to
+	 * the heap for nodes of higher degree.  Accessing the kth
+	 * child is O(1) and the traversal iterators read the
+	 * addresses of the children from this array instead of
+	 * following the next sibling pointer of each child.  The
+	 * cost is the memory of the array in every node.  N must
+	 * be at least 1.
+	 ****************************************************/
+
+	struct linked_children {
+		static bool const indexed = false;
+		static int const inline_capacity = 0;
+	};
+
+	template <int N = 4>
+	struct indexed_children {
+		static_assert( N > 0, "indexed_children requires an inline capacity of at least one child" );
+
+		static bool const indexed = true;
+		static int const inline_capacity = N;
+	};
+
+	/****************************************************
+	 * Tree Node Children Class
+	 *   class tree_node_children<Node, Indexed, N>
 	 *
-	 * The height and size of the subtree defined by
-	 * the referenced tree node and all its descendants
-	 * may be accessed.
+	 * The base class of a tree node which, if the children
+	 * are indexed, stores the array of pointers to the
+	 * children of the node.  It is notified whenever a child
+	 * is linked into or unlinked from the list of children.
 	 *
-	 * An iterator starting at the first child may
-	 * be accessed and an iterator pointing to the
-	 * parent may also be accessed.
+	 * The first N entries are stored within the node;  once
+	 * the degree exceeds N, the array is moved to the heap
+	 * and its capacity is doubled as required.
 	 ****************************************************/
 
-	template <typename Type>
-	class General_tree<Type>::iterator {
+	template <typename Node, bool Indexed, int N>
+	class tree_node_children {
 		public:
-			iterator();
+			Node *child( int ) const;
+			Node * const *child_array() const { return 0; }
+			int child_count() const;
+			void child_linked( Node * ) {}
+			void child_unlinked( Node * ) {}
+	};
 
-			int degree() const;
-			int depth() const;
-			int height() const;
-			int size() const;
-			bool leaf() const;
-			bool root() const;
+	template <typename Node, int N>
+	class tree_node_children<Node, true, N> {
+		public:
+			tree_node_children();
+			~tree_node_children();
+
+			Node *child( int k ) const { return child_list[k]; }
+			Node * const *child_array() const { return child_list; }
+			int child_count() const { return child_total; }
+			void child_linked( Node * );
+			void child_unlinked( Node * );
+
+		private:
+			Node **child_list;
+			int child_total;
+			int child_capacity;
+			Node *inline_list[N];
+
+			tree_node_children( tree_node_children const & );
+			tree_node_children &operator=( tree_node_children const & );
+	};
+
+	/*
+	 * Linked Child Access
+	 *   Node *tree_node_children<Node, false, N> :: child( int k ) const
+	 *
+	 * Follows the next sibling pointers from the first child
+	 * to the kth child.
+	 *
+	 * O(k)
+	 */
+
+	template <typename Node, bool Indexed, int N>
+	Node *tree_node_children<Node, Indexed, N>::child( int k ) const {
+		Node *ptr = static_cast<Node const *>( this )->children_head;
+
+		for ( ; ptr != 0 && k > 0; --k ) {
+			ptr = ptr->next_sibling;
+		}
+
+		return ptr;
+	}
+
+	template <typename Node, bool Indexed, int N>
+	int tree_node_children<Node, Indexed, N>::child_count() const {
+		int count = 0;
+
+		for ( Node const *ptr = static_cast<Node const *>( this )->children_head; ptr != 0; ptr = ptr->next_sibling ) {
+			++count;
+		}
+
+		return count;
+	}
+
+	template <typename Node, int N>
+	tree_node_children<Node, true, N>::tree_node_children():
+	child_list( inline_list ),
+	child_total( 0 ),
+	child_capacity( N ) {
+		// Empty constructor
+	}
+
+	template <typename Node, int N>
+	tree_node_children<Node, true, N>::~tree_node_children() {
+		if ( child_list != inline_list ) {
+			delete [] child_list;
+		}
+	}
+
+	/*
+	 * Child Linked
+	 *   void tree_node_children<Node, true, N> :: child_linked( Node *child )
+	 *
+	 * Places the child into the array immediately after its
+	 * previous sibling (or first, if it has none), doubling
+	 * the capacity of the array if it is full.
+	 *
+	 * O(1) amortized when appending; O(degree) otherwise
+	 */
+
+	template <typename Node, int N>
+	void tree_node_children<Node, true, N>::child_linked( Node *child ) {
+		if ( child_total == child_capacity ) {
+			Node **tmp = new Node *[2*child_capacity];
+
+			for ( int i = 0; i < child_total; ++i ) {
+				tmp[i] = child_list[i];
+			}
+
+			if ( child_list != inline_list ) {
+				delete [] child_list;
+			}
+
+			child_list = tmp;
+			child_capacity *= 2;
+		}
+
+		int position = child_total;
+
+		if ( child->previous_sibling == 0 ) {
+			position = 0;
+		} else if ( child_total == 0 || child_list[child_total - 1] != child->previous_sibling ) {
+			for ( position = 0; child_list[position] != child->previous_sibling; ++position ) {
+				// Find the previous sibling
+			}
+
+			++position;
+		}
+
+		for ( int i = child_total; i > position; --i ) {
+			child_list[i] = child_list[i - 1];
+		}
+
+		child_list[position] = child;
+		++child_total;
+	}
+
+	/*
+	 * Child Unlinked
+	 *   void tree_node_children<Node, true, N> :: child_unlinked( Node *child )
+	 *
+	 * Removes the child from the array.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Node, int N>
+	void tree_node_children<Node, true, N>::child_unlinked( Node *child ) {
+		int position = child_total - 1;
+
+		while ( position >= 0 && child_list[position] != child ) {
+			--position;
+		}
+
+		if ( position < 0 ) {
+			return;
+		}
+
+		for ( int i = position + 1; i < child_total; ++i ) {
+			child_list[i - 1] = child_list[i];
+		}
+
+		--child_total;
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *          Subtree Aggregate Policies          * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Subtree Aggregate Policies
+	 *   struct no_aggregate
+	 *   struct sum_aggregate<Type>
+	 *   struct min_aggregate<Type>
+	 *   struct max_aggregate<Type>
+	 *   struct count_if_aggregate<Type, Predicate>
+	 *
+	 * A policy selecting a value which is stored in each
+	 * node of a general tree and which summarizes the
+	 * objects stored in the subtree defined by that node.
+	 *
+	 * A policy defines:
+	 *   value_type                    the type of the aggregate,
+	 *   lift( Type const & )          the aggregate of one object, and
+	 *   combine( value_type const &, value_type const & )
+	 *                                 an associative operation.
+	 *
+	 * The aggregate of a node is the lifted object of the
+	 * node combined, from left to right, with the aggregates
+	 * of each of its children.  As every subtree contains at
+	 * least one node, no identity element is required.
+	 *
+	 * The sum, minimum and maximum policies also define
+	 *   apply( value_type const &, value_type const &d, int n )
+	 * giving the aggregate of n objects after d is added to
+	 * each of them;  this is used by Path_index::path_update.
+	 *
+	 * With no_aggregate (the default), nothing is stored and
+	 * the maintenance is compiled out.
+	 ****************************************************/
+
+	struct no_aggregate {
+		typedef void value_type;
+	};
+
+	template <typename Type>
+	struct sum_aggregate {
+		typedef Type value_type;
+
+		static value_type lift( Type const &obj ) { return obj; }
+		static value_type combine( value_type const &a, value_type const &b ) { return a + b; }
+		static value_type apply( value_type const &a, value_type const &d, int n ) { return a + d*n; }
+	};
+
+	template <typename Type>
+	struct min_aggregate {
+		typedef Type value_type;
+
+		static value_type lift( Type const &obj ) { return obj; }
+		static value_type combine( value_type const &a, value_type const &b ) { return std::min( a, b ); }
+		static value_type apply( value_type const &a, value_type const &d, int ) { return a + d; }
+	};
+
+	template <typename Type>
+	struct max_aggregate {
+		typedef Type value_type;
+
+		static value_type lift( Type const &obj ) { return obj; }
+		static value_type combine( value_type const &a, value_type const &b ) { return std::max( a, b ); }
+		static value_type apply( value_type const &a, value_type const &d, int ) { return a + d; }
+	};
+
+	template <typename Type, typename Predicate>
+	struct count_if_aggregate {
+		typedef int value_type;
+
+		static value_type lift( Type const &obj ) { return Predicate()( obj ) ? 1 : 0; }
+		static value_type combine( value_type const &a, value_type const &b ) { return a + b; }
+	};
+
+	/****************************************************
+	 * Tree Node Aggregate Class
+	 *   class tree_node_aggregate<Node, Aggregate>
+	 *
+	 * The base class of a tree node which stores the
+	 * aggregate of the subtree defined by the node or,
+	 * with no_aggregate, is empty and does nothing.
+	 *
+	 * The aggregate of the node is initialized from the
+	 * object stored in the node:  a new node is a leaf.
+	 ****************************************************/
+
+	template <typename Node, typename Aggregate>
+	class tree_node_aggregate {
+		public:
+			typename Aggregate::value_type node_aggregate;
+
+			template <typename Type>
+			explicit tree_node_aggregate( Type const &obj ):node_aggregate( Aggregate::lift( obj ) ) {}
+			typename Aggregate::value_type const &aggregate() const { return node_aggregate; }
+
+			static bool const aggregated = true;
+
+			void update_aggregate();
+			void append_aggregate( Node const * );
+	};
+
+	template <typename Node>
+	class tree_node_aggregate<Node, no_aggregate> {
+		public:
+			template <typename Type>
+			explicit tree_node_aggregate( Type const & ) {}
+
+			static bool const aggregated = false;
+
+			void update_aggregate() {}
+			void append_aggregate( Node const * ) {}
+	};
+
+	/*
+	 * Update the Aggregate
+	 *   void tree_node_aggregate<Node, Aggregate> :: update_aggregate()
+	 *
+	 * Recomputes the aggregate of the node from its object
+	 * and the (up-to-date) aggregates of its children.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Node, typename Aggregate>
+	void tree_node_aggregate<Node, Aggregate>::update_aggregate() {
+		Node const *node = static_cast<Node const *>( this );
+		typename Aggregate::value_type value = Aggregate::lift( node->element );
+
+		for ( Node const *child = node->children_head; child != 0; child = child->next_sibling ) {
+			value = Aggregate::combine( value, child->node_aggregate );
+		}
+
+		node_aggregate = value;
+	}
+
+	/*
+	 * Append to the Aggregate
+	 *   void tree_node_aggregate<Node, Aggregate> :: append_aggregate( Node const *child )
+	 *
+	 * Combines the aggregate of the node with that of a
+	 * child which was just appended as its last child.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Node, typename Aggregate>
+	void tree_node_aggregate<Node, Aggregate>::append_aggregate( Node const *child ) {
+		node_aggregate = Aggregate::combine( node_aggregate, child->node_aggregate );
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *               Traversal Range                * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Traversal Range Class
+	 *   class traversal_range<Iterator>
+	 *
+	 * A pair of traversal iterators, the first referring to
+	 * the first node visited and the second being the end
+	 * iterator of the traversal, which may be used with a
+	 * range-based for loop.
+	 *
+	 * The iterators of the general tree are forward
+	 * iterators (each has the standard member types and a
+	 * const operator*) and the end iterator is the sentinel,
+	 * so with C++20 the range is a std::ranges::view and may
+	 * be composed with the range adaptors, e.g.,
+	 *
+	 *     tree.preorder() | std::views::filter( pred ) | std::views::take( n )
+	 *
+	 * The adaptors are lazy:  the traversal only advances
+	 * when the composed view is incremented, so take( n )
+	 * visits no more than n of the matching nodes.
+	 ****************************************************/
+
+	template <typename Iterator>
+	class traversal_range
+#if __cplusplus >= 202002L
+	: public std::ranges::view_interface<traversal_range<Iterator> >
+#endif
+	{
+		public:
+			typedef Iterator iterator;
+
+			traversal_range();
+			traversal_range( Iterator, Iterator );
+
+			Iterator begin() const;
+			Iterator end() const;
+
+		private:
+			Iterator first;
+			Iterator last;
+	};
+
+	template <typename Iterator>
+	traversal_range<Iterator>::traversal_range():
+	first(),
+	last() {
+		// Empty constructor
+	}
+
+	template <typename Iterator>
+	traversal_range<Iterator>::traversal_range( Iterator b, Iterator e ):
+	first( b ),
+	last( e ) {
+		// Empty constructor
+	}
+
+	template <typename Iterator>
+	Iterator traversal_range<Iterator>::begin() const {
+		return first;
+	}
+
+	template <typename Iterator>
+	Iterator traversal_range<Iterator>::end() const {
+		return last;
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *                 General Tree                 * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * General Tree Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate>
+	 *
+	 * Author: Douglas Wilhelm Harder
+	 * 2009-10-10
+	 *
+	 * A general tree class which attempts to generalize
+	 * the philosophy of the weak ordering used in the
+	 * STL to a hierarchical ordering.  The ordering
+	 * is explicit:  the programmer dictates which
+	 * objects are placed as children to a specific
+	 * object.
+	 *
+	 * The second template argument is a metadata policy
+	 * (see tree_metadata) which selects which of the degree,
+	 * depth, height, and size of each node are stored and
+	 * maintained; the others are computed when requested.
+	 *
+	 * The third template argument is a child storage policy
+	 * (see linked_children and indexed_children) which
+	 * selects whether the children of each node are also
+	 * stored in an array for O(1) access to the kth child.
+	 *
+	 * The fourth template argument is a subtree aggregate
+	 * policy (see no_aggregate and sum_aggregate) which
+	 * selects an associative summary of the objects in the
+	 * subtree of each node which is stored and maintained.
+	 *
+	 * There are very few functions which work on	
+	 * general trees:
+	 *  - a constructor and destructor
+	 *  - empty, height, size, aggregate, and clear
+	 *  - remove_if, which removes in one pass all
+	 *    subtrees below a node which are rooted at a
+	 *    node storing an object satisfying a predicate
+	 *  - rebuild_metadata and verify, which recompute or
+	 *    check the stored metadata of every node
+	 *  - transaction, which batches insertions, erasures
+	 *    and moves of subtrees which are then either all
+	 *    committed or all rolled back (see transaction_log)
+	 *  - generation, which changes whenever nodes are
+	 *    added, removed, moved or relocated
+	 *  - at_preorder, which finds the kth node in
+	 *    pre-order using the sizes of the subtrees
+	 *  - equal_subtree and diff, which compare subtrees
+	 *    and skip those with different (respectively
+	 *    equal) hashes, and probably_equal_subtree, which
+	 *    only compares the hashes
+	 *  - compact, which moves all nodes into one block
+	 *    in depth-first or breadth-first order
+	 *
+	 * All other functionality is moved to the
+	 * iterators, of which there are five sorts:
+	 *    - an explicit iterator where the programmer
+	 *      can traverse either up or down the edges
+	 *      of a tree
+	 *
+	 *    - a depth-first traversal iterator which
+	 *      begins at the root node and steps through
+	 *      the nodes in a depth-first traversal	
+	 *      order visiting each node once
+	 *
+	 *    - a pre-order traversal iterator which visits
+	 *      the nodes in the same order as the depth-first
+	 *      traversal iterator but which requires neither a
+	 *      stack nor any memory allocation
+	 *
+	 *    - a breadth-first traversal iterator which
+	 *      begins at the root node and steps through
+	 *      the nodes in a breadth-first traversal
+	 *      order visiting each node once
+	 *
+	 *    - a post-order traversal iterator which
+	 *      begins at the left-most leaf node and steps
+	 *      through the nodes visiting every node after
+	 *      all of its descendants, ending at the root
+	 *
+	 * Both the depth-first and breadth-first traversal
+	 * iterators may be given a predicate which decides
+	 * for each node whether or not its descendants are
+	 * to be visited.  The breadth-first traversal may
+	 * also be restricted to the nodes up to a given depth,
+	 * and the nodes at one specific depth are returned by
+	 * level( d ).
+	 *
+	 * The pre-order, post-order and breadth-first traversals
+	 * of the whole tree are also returned as ranges by
+	 * preorder(), postorder() and breadth() (see
+	 * traversal_range).
+	 *
+	 * In order to perform a mixed-order traversal, the
+	 * programmer use the explicit iterator together
+	 * with a stack or queue.
+	 ****************************************************/
+
+	template <typename Type, typename Metadata = full_metadata, typename Children = linked_children, typename Aggregate = no_aggregate>
+	class General_tree {
+		public:
+			class iterator;
+			class depth_iterator;
+			class breadth_iterator;
+			class postorder_iterator;
+			class preorder_iterator;
+			class transaction_log;
+
+			typedef std::function<bool ( iterator )> descend_predicate;
+			typedef Metadata metadata_type;
+			typedef typename Aggregate::value_type aggregate_type;
+
+			enum compact_order { depth_first, breadth_first };
+
+			General_tree( Type const &obj = Type() );
+			~General_tree();
+			bool empty() const;
+			int size() const;
+			int height() const;
+			aggregate_type aggregate() const;
+			unsigned long generation() const;
+
+			void clear();
+
+			template <typename Predicate>
+			int remove_if( iterator root, Predicate pred );
+
+			void rebuild_metadata();
+			int verify( std::ostream &out = std::cerr ) const;
+
+			transaction_log transaction();
+
+			iterator begin();
+			iterator end();
+			iterator at_preorder( int k );
+
+			depth_iterator begin_depth();
+			depth_iterator begin_depth( descend_predicate const & );
+			depth_iterator end_depth();
+
+			breadth_iterator begin_breadth();
+			breadth_iterator begin_breadth( descend_predicate const & );
+			breadth_iterator begin_breadth( int max_depth );
+			breadth_iterator end_breadth();
+
+			std::vector<iterator> level( int d );
+
+			postorder_iterator begin_postorder();
+			postorder_iterator end_postorder();
+
+			preorder_iterator begin_preorder();
+			preorder_iterator end_preorder();
+
+			traversal_range<preorder_iterator> preorder();
+			traversal_range<postorder_iterator> postorder();
+			traversal_range<breadth_iterator> breadth();
+
+			static bool equal_subtree( iterator, iterator );
+			static bool probably_equal_subtree( iterator, iterator );
+			static std::vector<std::pair<iterator, iterator> > diff( General_tree &, General_tree & );
+
+			void compact( compact_order order = depth_first );
+
+		private:
+			class tree_node;
+			tree_node *root_node;
+			tree_node *block;
+
+			// The changes made through the tree and, as iterators
+			// do not refer to their tree, through the iterators of
+			// all trees of this type;  each count of removals also
+			// counts the relocations by compact()
+			unsigned long structure_generation;
+			unsigned long removal_generation;
+			static std::atomic<unsigned long> shared_generation;
+			static std::atomic<unsigned long> shared_removals;
+
+			unsigned long removals() const;
+
+		friend class iterator;
+		friend class depth_iterator;
+		friend class breadth_iterator;
+		friend class postorder_iterator;
+		friend class preorder_iterator;
+		friend class transaction_log;
+		friend class tree_node;
+		template <typename Tree, typename Op> friend class Path_index;
+		template <typename Tree> friend class Locked_tree;
+		template <typename Tree> friend class Journaled_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *                  Tree Node                   * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Tree Node Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate> :: Tree_node
+	 *
+	 * Author: Douglas Wilhelm Harder
+	 * 2009-10-10
+	 *
+	 * A tree node class for representing node stored
+	 * in this general tree.  These nodes contain:
+	 *
+	 * Pointers to:
+	 *   The parent tree node,
+	 *   The next and previous sibling tree nodes, and
+	 *   The head and tail pointers for a doubly linked
+	 *   list of children nodes.
+	 *
+	 * Other information stored includes:
+	 *   The degree, depth, height, and size of the
+	 *   node and the asssociated subtree defined by
+	 *   this node and all its descendants.
+	 *
+	 * Only the fields selected by the metadata policy
+	 * are members of the node (inherited from the
+	 * tree_node_degree, tree_node_depth, tree_node_height,
+	 * tree_node_size and tree_node_hash classes);  the
+	 * degree(), depth(), height(), size() and hash() member
+	 * functions return either the stored value or a value
+	 * computed on demand.
+	 *
+	 * If the children are indexed, the node also stores
+	 * the array of pointers to its children (inherited
+	 * from the tree_node_children class) which is kept
+	 * up to date by append_child() and unlink_child().
+	 *
+	 * If there is a subtree aggregate, the node also stores
+	 * the aggregate of its subtree (inherited from the
+	 * tree_node_aggregate class).  The hash and aggregate
+	 * depend on the objects in the subtree and are updated
+	 * by update_node() and update_ancestors().
+	 *
+	 * A node is either allocated on its own or, if pooled
+	 * is set, constructed within the block of nodes of a
+	 * compacted tree;  destroy() deletes or only destructs
+	 * the node, respectively.  The flag follows the object
+	 * so that it usually occupies padding.
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	class General_tree<Type, Metadata, Children, Aggregate>::tree_node:
+	public tree_node_degree<tree_node, Metadata::degree>,
+	public tree_node_depth<tree_node, Metadata::depth>,
+	public tree_node_height<tree_node, Metadata::height>,
+	public tree_node_size<tree_node, Metadata::size>,
+	public tree_node_hash<tree_node, Metadata::hash>,
+	public tree_node_children<tree_node, Children::indexed, Children::inline_capacity>,
+	public tree_node_aggregate<tree_node, Aggregate> {
+		public:
+			Type element;
+			bool pooled;
+			tree_node *parent;
+			tree_node *previous_sibling;
+			tree_node *next_sibling;
+			tree_node *children_head;
+			tree_node *children_tail;
+
+			tree_node( Type const &, tree_node *, tree_node *, tree_node *, int );
+			void append_child( tree_node * );
+			void insert_child( tree_node *, tree_node * );
+			void unlink_child( tree_node * );
+			void update_node();
+			void update_ancestors();
+			void recompute();
+			void destroy();
+			void clear();
+			// iterator find( Type const & );
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *                   Iterator                   * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Iterator Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate> :: iterator
+	 *
+	 * Author: Douglas Wilhelm Harder
+	 * 2009-10-10
+	 *
+	 * The object stored in the tree node referenced
+	 * by the iterator may be accessed with operator*
+	 *
+	 * The depth and degree of the referenced tree node
+	 * may be retrieved, and
+	 * The status of the tree node as a leaf node may
+	 * also be queried.
+	 *
+	 * The height, size, hash and aggregate of the subtree
+	 * defined by the referenced tree node and all its
+	 * descendants may be accessed.  The object should be
+	 * replaced with update() if the hash or a subtree
+	 * aggregate is stored:  assigning to it through
+	 * operator* updates neither.
+	 *
+	 * An iterator starting at the first child may
+	 * be accessed and an iterator pointing to the
+	 * parent may also be accessed.
+	 *
+	 * Depth-first and breadth-first traversal iterators
+	 * restricted to the subtree defined by the referenced
+	 * tree node may also be accessed.
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	class General_tree<Type, Metadata, Children, Aggregate>::iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Type *pointer;
+			typedef Type &reference;
+
+			iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+			int preorder_rank() const;
+			std::size_t hash() const;
+			aggregate_type aggregate() const;
+
+			void insert( Type const &obj );
+			void update( Type const &obj );
+			int search (Type const &obj, iterator itr);
+			int search_ ( Type const &obj, iterator itr);
+			void remove( Type const &obj, iterator itr);
+			//int remove_( Type const &obj, iterator itr);
+
+
+			iterator &operator++();
+			iterator operator++( int );
+			Type &operator*() const;
+			bool operator==( iterator const &rhs ) const;
+			bool operator!=( iterator const &rhs ) const;
+
+			iterator parent();
+			iterator begin();
+			iterator end();
+			iterator child( int k );
+
+			depth_iterator begin_depth();
+			depth_iterator begin_depth( descend_predicate const & );
+			depth_iterator end_depth();
+
+			breadth_iterator begin_breadth();
+			breadth_iterator begin_breadth( descend_predicate const & );
+			breadth_iterator begin_breadth( int max_depth );
+			breadth_iterator end_breadth();
+
+		private:
+			tree_node *current_node;
+			tree_node *parent_node;
+			iterator( tree_node *, tree_node * );
+
+		friend class General_tree;
+		template <typename Tree, typename Op> friend class Path_index;
+		template <typename Tree> friend class Locked_tree;
+		template <typename Tree> friend class Journaled_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *        Depth-first Traversal Iterator        * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Iterator Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate> :: iterator
+	 *
+	 * Author: Douglas Wilhelm Harder
+	 * 2009-10-10
+	 *
+	 * ...
+	 *
+	 * The children of the currently referred to node are
+	 * not visited if skip_children() is called before the
+	 * iterator is incremented or if the descend predicate
+	 * (if any) returns false for that node.  The pruned
+	 * subtrees are never pushed onto the stack.
+	 *
+	 * The stack is stored in a contiguous buffer which may
+	 * be pre-sized with reserve( n ); the size of the subtree
+	 * being traversed is always a sufficient capacity.
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	class General_tree<Type, Metadata, Children, Aggregate>::depth_iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Type *pointer;
+			typedef Type &reference;
+
+			depth_iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			void skip_children();
+			void reserve( int );
+
+			depth_iterator &operator++();
+			depth_iterator operator++( int );
+			Type &operator*() const;
+			bool operator==( depth_iterator const &rhs ) const;
+			bool operator!=( depth_iterator const &rhs ) const;
+
+		private:
+			std::vector<tree_node *> stack;
+			descend_predicate descend;
+			bool children_skipped;
+			depth_iterator( tree_node *, descend_predicate const & = descend_predicate() );
+
+		friend class General_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *       Breadth-first Traversal Iterator       * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Iterator Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate> :: iterator
+	 *
+	 * Author: Douglas Wilhelm Harder
+	 * 2009-10-10
+	 *
+	 * ...
+	 *
+	 * The children of the currently referred to node are
+	 * not visited if skip_children() is called before the
+	 * iterator is incremented or if the descend predicate
+	 * (if any) returns false for that node.  The pruned
+	 * subtrees are never placed into the queue.
+	 *
+	 * Similarly, if a maximum depth is given, the children
+	 * of nodes at that depth are never placed into the queue.
+	 *
+	 * The queue is stored in a contiguous buffer which may
+	 * be pre-sized with reserve( n ); the size of the subtree
+	 * being traversed is always a sufficient capacity.
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	class General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Type *pointer;
+			typedef Type &reference;
+
+			breadth_iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			void skip_children();
+			void reserve( int );
+
+			breadth_iterator &operator++();
+			breadth_iterator operator++( int );
+			Type &operator*() const;
+			bool operator==( breadth_iterator const &rhs ) const;
+			bool operator!=( breadth_iterator const &rhs ) const;
+
+		private:
+			std::vector<tree_node *> queue;
+			std::size_t queue_front;
+			descend_predicate descend;
+			bool children_skipped;
+			int depth_limit;
+			breadth_iterator( tree_node *, descend_predicate const & = descend_predicate(), int = INT_MAX );
+
+		friend class General_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *         Post-order Traversal Iterator        * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Iterator Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate> :: postorder_iterator
+	 *
+	 * A post-order traversal iterator which visits every
+	 * node after all of its descendants.
+	 *
+	 * No stack or queue is required:  the iterator only
+	 * stores the current tree node together with the root
+	 * of the traversal and moves using the parent, next
+	 * sibling and children head pointers of the tree nodes.
+	 * Consequently, no memory is allocated and copying an
+	 * iterator is O(1).
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	class General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Type *pointer;
+			typedef Type &reference;
+
+			postorder_iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			postorder_iterator &operator++();
+			postorder_iterator operator++( int );
+			Type &operator*() const;
+			bool operator==( postorder_iterator const &rhs ) const;
+			bool operator!=( postorder_iterator const &rhs ) const;
+
+		private:
+			tree_node *current_node;
+			tree_node *root_node;
+			postorder_iterator( tree_node * );
+
+			static tree_node *first_leaf( tree_node * );
+
+		friend class General_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *          Pre-order Traversal Iterator        * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Iterator Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate> :: preorder_iterator
+	 *
+	 * A pre-order traversal iterator which visits the
+	 * nodes in the same order as the depth-first traversal
+	 * iterator.
+	 *
+	 * The iterator stores nothing but a pointer to the
+	 * current tree node:  the next node is found using the
+	 * children head, next sibling and parent pointers of
+	 * the tree nodes.  No memory is allocated, copying an
+	 * iterator is O(1), and the entire subtree of the
+	 * current node may be skipped with skip_subtree().
+	 *
+	 * The traversal always ends once the root node of the
+	 * tree has been left.
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	class General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator {
+		public:
+			typedef std::forward_iterator_tag iterator_category;
+			typedef Type value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef Type *pointer;
+			typedef Type &reference;
+
+			preorder_iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			void skip_subtree();
+
+			preorder_iterator &operator++();
+			preorder_iterator operator++( int );
+			Type &operator*() const;
+			bool operator==( preorder_iterator const &rhs ) const;
+			bool operator!=( preorder_iterator const &rhs ) const;
+
+		private:
+			tree_node *current_node;
+			preorder_iterator( tree_node * );
+
+		friend class General_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *                 Transaction                  * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Transaction Class
+	 *   class General_tree<Type, Metadata, Children, Aggregate> :: transaction_log
+	 *
+	 * A batch of insertions, erasures and moves of subtrees
+	 * (splices) which are either all kept, by commit(), or
+	 * all undone, by rollback().  A transaction which is
+	 * destroyed while still active is rolled back, so an
+	 * exception thrown part way through a batch leaves the
+	 * tree as it was.
+	 *
+	 * Each edit changes only the links of the nodes and
+	 * appends a record of four words to an undo log:  the
+	 * sort of edit, the node, and its former parent and
+	 * previous sibling.  The degree, height, size, hash and
+	 * aggregate of the ancestors are not updated until
+	 * commit() recomputes each affected node once, children
+	 * before parents, and erased subtrees are only unlinked
+	 * so that rollback() can relink them.  The depths of
+	 * new and moved nodes are kept up to date.
+	 *
+	 * While the transaction is active, the tree may only be
+	 * modified through it, and the degree, height, size, hash
+	 * and aggregate of the ancestors of edited nodes are
+	 * those from before the transaction.
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	class General_tree<Type, Metadata, Children, Aggregate>::transaction_log {
+		public:
+			transaction_log( transaction_log && );
+			~transaction_log();
+
+			bool active() const;
+			int edits() const;
+
+			iterator insert( iterator parent, Type const &obj );
+			void erase( iterator itr );
+			void splice( iterator itr, iterator new_parent );
+
+			void commit();
+			void rollback();
+
+		private:
+			enum edit_kind { inserted, erased, spliced };
+
+			struct undo_record {
+				edit_kind kind;
+				tree_node *node;
+				tree_node *parent;
+				tree_node *previous;
+			};
+
+			// A node whose metadata is recomputed by commit()
+			struct affected_node {
+				tree_node *node;
+				int pending;
+				affected_node *parent;
+			};
+
+			General_tree *tree;
+			std::vector<undo_record> log;
+
+			explicit transaction_log( General_tree * );
+			transaction_log( transaction_log const & );
+			transaction_log &operator=( transaction_log const & );
+
+			static void shift_depth( tree_node *, int );
+			static void discard( tree_node * );
+
+		friend class General_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *           General Tree Definitions           * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Destructor
+	 *   General_tree<Type, Metadata, Children, Aggregate> :: ~General_tree()
+	 *
+	 * Create a new tree node storing the object.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::General_tree( Type const &obj ):
+	root_node( new tree_node( obj, 0, 0, 0, 0 ) ),
+	block( 0 ),
+	structure_generation( 0 ),
+	removal_generation( 0 ) {
+		// Empty constructor
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	std::atomic<unsigned long> General_tree<Type, Metadata, Children, Aggregate>::shared_generation( 0 );
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	std::atomic<unsigned long> General_tree<Type, Metadata, Children, Aggregate>::shared_removals( 0 );
+
+	/*
+	 * Destructor
+	 *   General_tree<Type, Metadata, Children, Aggregate> :: ~General_tree()
+	 *
+	 * Must recursively clear all objects within
+	 * the tree and then free the block of nodes of
+	 * the last compaction (if any).
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::~General_tree() {
+		root_node->clear();
+		::operator delete( block );
+	}
+
+	/*
+	 * Empty
+	 *   bool General_tree<Type, Metadata, Children, Aggregate> :: empty() const
+	 *
+	 * Returns 'false':  there is always a root
+	 * node in the general tree.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::empty() const {
+		return false;
+	}
+
+	/*
+	 * Size
+	 *   int General_tree<Type, Metadata, Children, Aggregate> :: size() const
+	 *
+	 * Returns the number of nodes within the
+	 * general tree.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::size() const {
+		return root_node->size();
+	}
+
+	/*
+	 * Height
+	 *   int General_tree<Type, Metadata, Children, Aggregate> :: height() const
+	 *
+	 * Returns the height of the general tree:
+	 * the lenght of the longest path from
+	 * the root node to a node within the tree.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::height() const {
+		return root_node->height();
+	}
+
+	/*
+	 * Aggregate
+	 *   aggregate_type General_tree<Type, Metadata, Children, Aggregate> :: aggregate() const
+	 *
+	 * Returns the subtree aggregate of all of the
+	 * objects within the general tree.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::aggregate_type General_tree<Type, Metadata, Children, Aggregate>::aggregate() const {
+		return root_node->aggregate();
+	}
+
+	/*
+	 * Generation
+	 *   unsigned long General_tree<Type, Metadata, Children, Aggregate> :: generation() const
+	 *
+	 * Returns a number which changes whenever nodes are added
+	 * to, removed from or moved within the tree or are moved
+	 * to new addresses by compact(), so that structures built
+	 * over the tree can tell when they must be rebuilt.
+	 *
+	 * Iterators do not refer to their tree, so insert() and
+	 * remove() of the iterators advance a count shared by all
+	 * trees of this type:  a change to another such tree also
+	 * changes the generation.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	unsigned long General_tree<Type, Metadata, Children, Aggregate>::generation() const {
+		return structure_generation + shared_generation.load( std::memory_order_relaxed );
+	}
+
+	/*
+	 * Removals
+	 *   unsigned long General_tree<Type, Metadata, Children, Aggregate> :: removals() const
+	 *
+	 * Returns a number which changes whenever nodes may have
+	 * been deleted, in this tree or through the iterators of
+	 * any tree of this type, or relocated by compact().
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	unsigned long General_tree<Type, Metadata, Children, Aggregate>::removals() const {
+		return removal_generation + shared_removals.load( std::memory_order_relaxed );
+	}
+
+	/*
+	 * Clear
+	 *   void General_tree<Type, Metadata, Children, Aggregate> :: clear()
+	 *
+	 * Removes all nodes except for the root node.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::clear() {
+		remove_if( begin(), []( Type const & ) { return true; } );
+	}
+
+	/*
+	 * Remove If
+	 *   int General_tree<Type, Metadata, Children, Aggregate> :: remove_if( iterator root, Predicate pred )
+	 *
+	 * Removes every strict descendant of the node referred to by
+	 * root which stores an object obj for which pred( obj ) is true,
+	 * together with its entire subtree, and returns the number of
+	 * nodes removed.  The root itself is never removed.
+	 *
+	 * The subtree is traversed once using an explicit stack:  a
+	 * child satisfying the predicate is unlinked and its subtree
+	 * deleted without testing its descendants, while every other
+	 * node is recorded.  The recorded nodes are then visited in
+	 * reverse, so that each node follows all of its descendants,
+	 * and their degrees, heights, sizes, hashes and aggregates are
+	 * recomputed from their children, followed by those of the
+	 * strict ancestors of root.
+	 *
+	 * O(n) where n is the size of the subtree of root, plus the
+	 * sum of the degrees of the ancestors of root
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	template <typename Predicate>
+	int General_tree<Type, Metadata, Children, Aggregate>::remove_if( iterator root, Predicate pred ) {
+		int removed = 0;
+
+		std::vector<tree_node *> stack( 1, root.current_node );
+		std::vector<tree_node *> kept;
+		std::vector<tree_node *> doomed;
+
+		while ( !stack.empty() ) {
+			tree_node *node = stack.back();
+			stack.pop_back();
+			kept.push_back( node );
+
+			// The next sibling must be read before the child is unlinked
+			for ( tree_node *child = node->children_head, *next; child != 0; child = next ) {
+				next = child->next_sibling;
+
+				if ( !pred( child->element ) ) {
+					stack.push_back( child );
+					continue;
+				}
+
+				node->unlink_child( child );
+				doomed.push_back( child );
+
+				while ( !doomed.empty() ) {
+					tree_node *victim = doomed.back();
+					doomed.pop_back();
+
+					for ( tree_node *grandchild = victim->children_head; grandchild != 0; grandchild = grandchild->next_sibling ) {
+						doomed.push_back( grandchild );
+					}
+
+					victim->destroy();
+					++removed;
+				}
+			}
+		}
+
+		if ( removed == 0 ) {
+			return 0;
+		}
+
+		++structure_generation;
+		++removal_generation;
+
+		for ( typename std::vector<tree_node *>::reverse_iterator itr = kept.rbegin(); itr != kept.rend(); ++itr ) {
+			( *itr )->recompute();
+		}
+
+		for ( tree_node *regress = root.current_node->parent; regress != 0; regress = regress->parent ) {
+			regress->recompute();
+		}
+
+		return removed;
+	}
+
+	/*
+	 * Rebuild the Metadata
+	 *   void General_tree<Type, Metadata, Children, Aggregate> :: rebuild_metadata()
+	 *
+	 * Recomputes the stored degree, depth, height, size, hash
+	 * and aggregate of every node in the tree.
+	 *
+	 * The tree is walked in post-order by following the links
+	 * of the nodes, so no stack is required:  the depth is
+	 * set on the way down and each node is recomputed from
+	 * its children once the last of them has been visited.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::rebuild_metadata() {
+		tree_node *node = root_node;
+		int d = 0;
+
+		node->set_depth( 0 );
+
+		while ( true ) {
+			// Descend to the first leaf node of the subtree
+			while ( node->children_head != 0 ) {
+				node = node->children_head;
+				node->set_depth( ++d );
+			}
+
+			// Recompute each node whose children are all done until
+			// one with a next sibling is found
+			while ( true ) {
+				node->recompute();
+
+				if ( node == root_node ) {
+					return;
+				}
+
+				if ( node->next_sibling != 0 ) {
+					node = node->next_sibling;
+					node->set_depth( d );
+					break;
+				}
+
+				node = node->parent;
+				--d;
+			}
+		}
+	}
+
+	/*
+	 * Verify the Metadata
+	 *   int General_tree<Type, Metadata, Children, Aggregate> :: verify( std::ostream &out ) const
+	 *
+	 * Checks, without modifying the tree, that the links of
+	 * every node agree with those of its children and that the
+	 * stored degree, depth, height and size of every node agree
+	 * with its parent and its children.  Each inconsistency is
+	 * written to out identifying the node by its position in a
+	 * pre-order traversal, and the number found is returned.
+	 *
+	 * If each node agrees with its children, every subtree is
+	 * correct by induction, so only the stored values of the
+	 * children are read:  the tree is walked in pre-order by
+	 * following the links of the nodes without a stack.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::verify( std::ostream &out ) const {
+		int errors = 0;
+		int position = 0;
+		int d = 0;
+
+		for ( tree_node const *node = root_node; node != 0; ++position ) {
+			int degree = 0;
+			int height = 0;
+			int size = 1;
+
+			tree_node const *previous = 0;
+
+			for ( tree_node const *child = node->children_head; child != 0; child = child->next_sibling ) {
+				if ( child->parent != node || child->previous_sibling != previous ) {
+					out << "pre-order " << position << ": child " << degree << " is not linked back" << std::endl;
+					++errors;
+				}
+
+				++degree;
+				previous = child;
+
+				if ( Metadata::height ) {
+					height = std::max( height, child->height() + 1 );
+				}
+
+				if ( Metadata::size ) {
+					size += child->size();
+				}
+			}
+
+			if ( node->children_tail != previous ) {
+				out << "pre-order " << position << ": the tail is not the last child" << std::endl;
+				++errors;
+			}
+
+			if ( Metadata::degree && node->degree() != degree ) {
+				out << "pre-order " << position << ": degree " << node->degree() << ", expected " << degree << std::endl;
+				++errors;
+			}
+
+			if ( Metadata::depth && node->depth() != d ) {
+				out << "pre-order " << position << ": depth " << node->depth() << ", expected " << d << std::endl;
+				++errors;
+			}
+
+			if ( Metadata::height && node->height() != height ) {
+				out << "pre-order " << position << ": height " << node->height() << ", expected " << height << std::endl;
+				++errors;
+			}
+
+			if ( Metadata::size && node->size() != size ) {
+				out << "pre-order " << position << ": size " << node->size() << ", expected " << size << std::endl;
+				++errors;
+			}
+
+			// Step to the next node in pre-order
+			if ( node->children_head != 0 ) {
+				node = node->children_head;
+				++d;
+			} else {
+				while ( node != root_node && node->next_sibling == 0 ) {
+					node = node->parent;
+					--d;
+				}
+
+				node = ( node == root_node ) ? 0 : node->next_sibling;
+			}
+		}
+
+		return errors;
+	}
+
+	/*
+	 * Transaction
+	 *   transaction_log General_tree<Type, Metadata, Children, Aggregate> :: transaction()
+	 *
+	 * Returns a new active transaction on the tree (see
+	 * transaction_log).
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::transaction_log General_tree<Type, Metadata, Children, Aggregate>::transaction() {
+		return transaction_log( this );
+	}
+
+	/*
+	 * Explicit Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin()
+	 *
+	 * Returns a explicit (programmer-directored) traversing
+	 * iterator which initially refers to the root node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::begin() {
+		return iterator( root_node, 0 );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::end() {
+		return iterator( 0, 0 );
+	}
+
+	/*
+	 * Pre-order Position
+	 *   iterator General_tree<Type> :: at_preorder( int k )
+	 *
+	 * Returns an explicit iterator referring to the kth node
+	 * (starting at 0 with the root node) visited in a pre-order
+	 * traversal of the tree, or end() if k is not less than
+	 * the size of the tree.
+	 *
+	 * Starting at the root, while k is not zero, the current
+	 * node is passed over by decrementing k and the children
+	 * are scanned:  each subtree containing fewer than k + 1
+	 * nodes is skipped by subtracting its size from k and the
+	 * first other subtree is entered.  The nodes within the
+	 * skipped subtrees are never visited.
+	 *
+	 * O(h x d) where d is the maximum degree, if the sizes are stored
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::at_preorder( int k ) {
+		if ( k < 0 || k >= root_node->size() ) {
+			return end();
+		}
+
+		tree_node *ptr = root_node;
+
+		while ( k > 0 ) {
+			--k;
+
+			tree_node *child = ptr->children_head;
+
+			while ( k >= child->size() ) {
+				k -= child->size();
+				child = child->next_sibling;
+			}
+
+			ptr = child;
+		}
+
+		return iterator( ptr, ptr->parent );
+	}
+
+	/*
+	 * Depth-first Traversing Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin_depth()
+	 *
+	 * Returns a depth-first traversing
+	 * iterator which initially refers to the root node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::begin_breadth() {
+		return breadth_iterator( root_node );
+	}
+
+	/*
+	 * Pruned Breadth-first Traversing Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin_breadth( descend_predicate const & )
+	 *
+	 * Returns a breadth-first traversing iterator which
+	 * initially refers to the root node and which only
+	 * visits the children of those nodes for which the
+	 * predicate returns true.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::begin_breadth( descend_predicate const &pred ) {
+		return breadth_iterator( root_node, pred );
+	}
+
+	/*
+	 * Depth-bounded Breadth-first Traversing Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin_breadth( int max_depth )
+	 *
+	 * Returns a breadth-first traversing iterator which
+	 * initially refers to the root node and which only
+	 * visits the nodes with a depth less than or equal
+	 * to the argument.  Nodes deeper than this are never
+	 * placed into the queue.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::begin_breadth( int max_depth ) {
+		return breadth_iterator( root_node, descend_predicate(), max_depth );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::end_breadth() {
+		return breadth_iterator();
+	}
+
+	/*
+	 * Level
+	 *   std::vector<iterator> General_tree<Type, Metadata, Children, Aggregate> :: level( int d )
+	 *
+	 * Returns explicit iterators referring to all nodes of
+	 * depth d, ordered from left to right.
+	 *
+	 * A subtree is only entered if it reaches depth d, that
+	 * is, if the depth plus the height of its root is at
+	 * least d, and nodes of depth d are never expanded.
+	 * Consequently, only the nodes on the paths from the
+	 * root to the nodes at depth d are visited.
+	 *
+	 * The depths are tracked during the traversal;  if the
+	 * heights are not stored, no subtrees are pruned.
+	 *
+	 * O(number of nodes on those paths)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	std::vector<typename General_tree<Type, Metadata, Children, Aggregate>::iterator> General_tree<Type, Metadata, Children, Aggregate>::level( int d ) {
+		std::vector<iterator> nodes;
+
+		if ( d < 0 || ( Metadata::height && root_node->height() < d ) ) {
+			return nodes;
+		}
+
+		// Each entry stores a node together with its depth
+		std::vector<std::pair<tree_node *, int> > stack( 1, std::make_pair( root_node, 0 ) );
+
+		while ( !stack.empty() ) {
+			tree_node *ptr = stack.back().first;
+			int ptr_depth = stack.back().second;
+			stack.pop_back();
+
+			if ( ptr_depth == d ) {
+				nodes.push_back( iterator( ptr, ptr->parent ) );
+				continue;
+			}
+
+			// Push the children which reach depth d in reverse
+			// order so that they are popped from left to right
+			for ( tree_node *child = ptr->children_tail; child != 0; child = child->previous_sibling ) {
+				if ( !Metadata::height || ptr_depth + 1 + child->height() >= d ) {
+					stack.push_back( std::make_pair( child, ptr_depth + 1 ) );
+				}
+			}
+		}
+
+		return nodes;
+	}
+
+	/*
+	 * Breadth-first Traversing Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin_breadth()
+	 *
+	 * Returns a breadth-first traversing
+	 * iterator which initially refers to the root node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator General_tree<Type, Metadata, Children, Aggregate>::begin_depth() {
+		return depth_iterator( root_node );
+	}
+
+	/*
+	 * Pruned Depth-first Traversing Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin_depth( descend_predicate const & )
+	 *
+	 * Returns a depth-first traversing iterator which
+	 * initially refers to the root node and which only
+	 * visits the children of those nodes for which the
+	 * predicate returns true.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator General_tree<Type, Metadata, Children, Aggregate>::begin_depth( descend_predicate const &pred ) {
+		return depth_iterator( root_node, pred );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator General_tree<Type, Metadata, Children, Aggregate>::end_depth() {
+		return depth_iterator();
+	}
+
+	/*
+	 * Post-order Traversing Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin_postorder()
+	 *
+	 * Returns a post-order traversing iterator which
+	 * initially refers to the left-most leaf node.
+	 *
+	 * O(h)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator General_tree<Type, Metadata, Children, Aggregate>::begin_postorder() {
+		return postorder_iterator( root_node );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator General_tree<Type, Metadata, Children, Aggregate>::end_postorder() {
+		return postorder_iterator();
+	}
+
+	/*
+	 * Pre-order Traversing Iterator
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate> :: begin_preorder()
+	 *
+	 * Returns a pre-order traversing iterator which
+	 * initially refers to the root node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator General_tree<Type, Metadata, Children, Aggregate>::begin_preorder() {
+		return preorder_iterator( root_node );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator General_tree<Type, Metadata, Children, Aggregate>::end_preorder() {
+		return preorder_iterator();
+	}
+
+	/*
+	 * Traversal Ranges
+	 *   traversal_range<preorder_iterator> General_tree<Type, Metadata, Children, Aggregate> :: preorder()
+	 *   traversal_range<postorder_iterator> General_tree<Type, Metadata, Children, Aggregate> :: postorder()
+	 *   traversal_range<breadth_iterator> General_tree<Type, Metadata, Children, Aggregate> :: breadth()
+	 *
+	 * Return the range of nodes of the tree visited in
+	 * pre-order, post-order or breadth-first order.  The
+	 * pre-order and post-order ranges allocate no memory.
+	 *
+	 * O(1) for pre-order and breadth-first;  O(h) for post-order
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	traversal_range<typename General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator> General_tree<Type, Metadata, Children, Aggregate>::preorder() {
+		return traversal_range<preorder_iterator>( begin_preorder(), end_preorder() );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	traversal_range<typename General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator> General_tree<Type, Metadata, Children, Aggregate>::postorder() {
+		return traversal_range<postorder_iterator>( begin_postorder(), end_postorder() );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	traversal_range<typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator> General_tree<Type, Metadata, Children, Aggregate>::breadth() {
+		return traversal_range<breadth_iterator>( begin_breadth(), end_breadth() );
+	}
+
+	/*
+	 * Equal Subtrees
+	 *   bool General_tree<Type> :: equal_subtree( iterator a, iterator b )
+	 *
+	 * Returns true if the subtrees defined by the two referred
+	 * to nodes store equal objects in the same shape.
+	 *
+	 * The subtrees are compared node by node in pre-order.  If
+	 * the hashes are stored, subtrees with different hashes
+	 * are not equal, so false is returned immediately if the
+	 * hashes of the two nodes, or of a pair of their
+	 * descendants, differ.
+	 *
+	 * O(1) if the hashes are stored and differ;  O(size of the
+	 * subtree) otherwise
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::equal_subtree( iterator a, iterator b ) {
+		if ( a.current_node == b.current_node ) {
+			return true;
+		}
+
+		if ( Metadata::hash && a.current_node->hash() != b.current_node->hash() ) {
+			return false;
+		}
+
+		std::vector<std::pair<tree_node const *, tree_node const *> > stack;
+		stack.push_back( std::make_pair( a.current_node, b.current_node ) );
+
+		while ( !stack.empty() ) {
+			tree_node const *x = stack.back().first;
+			tree_node const *y = stack.back().second;
+			stack.pop_back();
+
+			if ( !( x->element == y->element ) ) {
+				return false;
+			}
+
+			tree_node const *i = x->children_head;
+			tree_node const *j = y->children_head;
+
+			for ( ; i != 0 && j != 0; i = i->next_sibling, j = j->next_sibling ) {
+				if ( Metadata::hash && i->hash() != j->hash() ) {
+					return false;
+				}
+
+				stack.push_back( std::make_pair( i, j ) );
+			}
+
+			if ( i != 0 || j != 0 ) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/*
+	 * Probably Equal Subtrees
+	 *   bool General_tree<Type> :: probably_equal_subtree( iterator a, iterator b )
+	 *
+	 * If the hashes are stored, returns true if the subtrees
+	 * defined by the two referred to nodes have equal hashes:
+	 * as in diff(), such subtrees are taken to be equal, which
+	 * is wrong only with negligible probability.  Otherwise,
+	 * returns equal_subtree( a, b ).
+	 *
+	 * O(1) if the hashes are stored;  O(size of the subtree)
+	 * otherwise
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::probably_equal_subtree( iterator a, iterator b ) {
+		if ( !Metadata::hash ) {
+			return equal_subtree( a, b );
+		}
+
+		return a.current_node == b.current_node || a.current_node->hash() == b.current_node->hash();
+	}
+
+	/*
+	 * Difference of Two Trees
+	 *   std::vector<std::pair<iterator, iterator> > General_tree<Type> :: diff( General_tree &a, General_tree &b )
+	 *
+	 * Matches the nodes of the two trees by position, starting
+	 * with the roots and pairing the kth children of matched
+	 * nodes, and returns:
+	 *   - each pair of matched nodes storing different objects,
+	 *   - ( x, b.end() ) for each node x of a with no match, and
+	 *   - ( a.end(), y ) for each node y of b with no match.
+	 * The descendants of an unmatched node are not listed, and
+	 * a node is listed before its descendants.
+	 *
+	 * If the hashes are stored, a pair of matched nodes with
+	 * equal hashes is taken to define identical subtrees, which
+	 * are skipped;  two different subtrees have equal hashes
+	 * only with negligible probability.
+	 *
+	 * O(n) if the hashes are not stored;  otherwise proportional
+	 * to the total degree of the nodes whose subtrees changed
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	std::vector<std::pair<typename General_tree<Type, Metadata, Children, Aggregate>::iterator, typename General_tree<Type, Metadata, Children, Aggregate>::iterator> > General_tree<Type, Metadata, Children, Aggregate>::diff( General_tree &a, General_tree &b ) {
+		std::vector<std::pair<iterator, iterator> > result;
+		std::vector<std::pair<tree_node *, tree_node *> > stack;
+		stack.push_back( std::make_pair( a.root_node, b.root_node ) );
+
+		while ( !stack.empty() ) {
+			tree_node *x = stack.back().first;
+			tree_node *y = stack.back().second;
+			stack.pop_back();
+
+			if ( Metadata::hash && x->hash() == y->hash() ) {
+				continue;
+			}
+
+			if ( !( x->element == y->element ) ) {
+				result.push_back( std::make_pair( iterator( x, x->parent ), iterator( y, y->parent ) ) );
+			}
+
+			tree_node *i = x->children_head;
+			tree_node *j = y->children_head;
+
+			for ( ; i != 0 && j != 0; i = i->next_sibling, j = j->next_sibling ) {
+				stack.push_back( std::make_pair( i, j ) );
+			}
+
+			for ( ; i != 0; i = i->next_sibling ) {
+				result.push_back( std::make_pair( iterator( i, x ), b.end() ) );
+			}
+
+			for ( ; j != 0; j = j->next_sibling ) {
+				result.push_back( std::make_pair( a.end(), iterator( j, y ) ) );
+			}
+		}
+
+		return result;
+	}
+
+	/*
+	 * Compact
+	 *   void General_tree<Type> :: compact( compact_order order )
+	 *
+	 * Moves all nodes of the tree into a single new block of
+	 * memory in the order they are visited by a depth-first
+	 * (pre-order) or a breadth-first traversal, so that later
+	 * traversals in that order read memory sequentially.
+	 *
+	 * The nodes are listed in the given order together with
+	 * the position of their parent in the list.  The copy of
+	 * each node is then constructed in the block and appended
+	 * to the children of the copy of its parent:  the children
+	 * of each node are listed in order, so the order of the
+	 * siblings is preserved.  The stored degree, height and
+	 * size are copied and, as each parent precedes its children
+	 * in the list, the hashes and aggregates are recomputed by
+	 * visiting the copies in reverse.  Finally, the old nodes
+	 * are destroyed and the block of the previous compaction
+	 * (if any) is freed.
+	 *
+	 * Nodes inserted later are allocated on their own, and
+	 * nodes in the block which are removed are destructed;  the
+	 * block itself is freed at the next compaction or when the
+	 * tree is destroyed.
+	 *
+	 * All iterators referring to the tree are invalidated,
+	 * any Path_index is rebuilt at its next use and any
+	 * Journaled_tree takes a checkpoint before its next edit,
+	 * as the nodes have new addresses.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::compact( compact_order order ) {
+		std::vector<tree_node *> list( 1, root_node );
+		std::vector<int> parent_of( 1, -1 );
+
+		if ( order == breadth_first ) {
+			for ( std::size_t i = 0; i < list.size(); ++i ) {
+				for ( tree_node *child = list[i]->children_head; child != 0; child = child->next_sibling ) {
+					list.push_back( child );
+					parent_of.push_back( static_cast<int>( i ) );
+				}
+			}
+		} else {
+			// Each entry is a node and the position of its parent;
+			// the children are pushed in reverse order
+			std::vector<std::pair<tree_node *, int> > stack;
+
+			for ( tree_node *child = root_node->children_tail; child != 0; child = child->previous_sibling ) {
+				stack.push_back( std::make_pair( child, 0 ) );
+			}
+
+			while ( !stack.empty() ) {
+				tree_node *node = stack.back().first;
+				int position = static_cast<int>( list.size() );
+
+				list.push_back( node );
+				parent_of.push_back( stack.back().second );
+				stack.pop_back();
+
+				for ( tree_node *child = node->children_tail; child != 0; child = child->previous_sibling ) {
+					stack.push_back( std::make_pair( child, position ) );
+				}
+			}
+		}
+
+		std::size_t n = list.size();
+		tree_node *copies = static_cast<tree_node *>( ::operator new( n*sizeof( tree_node ) ) );
+
+		for ( std::size_t i = 0; i < n; ++i ) {
+			tree_node *old = list[i];
+			tree_node *copy = new ( copies + i ) tree_node( old->element, 0, 0, 0, Metadata::depth ? old->depth() : 0 );
+
+			copy->pooled = true;
+
+			if ( parent_of[i] != -1 ) {
+				copies[parent_of[i]].append_child( copy );
+			}
+
+			if ( Metadata::degree ) {
+				copy->set_degree( old->degree() );
+			}
+
+			if ( Metadata::height ) {
+				copy->set_height( old->height() );
+			}
+
+			if ( Metadata::size ) {
+				copy->set_size( old->size() );
+			}
+		}
+
+		if ( Metadata::hash || tree_node::aggregated ) {
+			for ( std::size_t i = n; i > 0; --i ) {
+				copies[i - 1].update_node();
+			}
+		}
+
+		for ( std::size_t i = 0; i < n; ++i ) {
+			list[i]->destroy();
+		}
+
+		::operator delete( block );
+		block = copies;
+		root_node = copies;
+
+		++structure_generation;
+		++removal_generation;
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *             Tree Node Definitions            * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Constructor
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate>::tree_node :: tree_node( ... )
+	 *
+	 * Constructs a new tree node where:
+	 *   The object stored is specified.
+	 *   Pointers to the nodes containing the parent, previous
+	 *   sibling, and next sibling are specified.
+	 *   The list of children is initially empty
+	 *     - Children head and tail and the degree are set to 0
+	 *  The depth is specified (and ignored if it is not stored).
+	 *  The height is 0 and the size is 1.
+	 *  The node is not pooled.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::tree_node::tree_node( Type const &obj, tree_node *par, tree_node *p, tree_node *n, int d ):
+	tree_node_hash<tree_node, Metadata::hash>( obj ),
+	tree_node_aggregate<tree_node, Aggregate>( obj ),
+	element( obj ),
+	pooled( false ),
+	parent( par ),
+	previous_sibling( p ),
+	next_sibling( n ),
+	children_head( 0 ),
+	children_tail( 0 ) {
+		this->set_depth( d );
+	}
+
+	/*
+	 * Append a Child
+	 *   void General_tree<Type>::tree_node :: append_child( tree_node *child )
+	 *
+	 * Links the child at the end of the list of children,
+	 * updating the array of children if they are indexed.
+	 * No other metadata is updated.
+	 *
+	 * O(1) amortized
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::append_child( tree_node *child ) {
+		child->parent = this;
+		child->previous_sibling = children_tail;
+		child->next_sibling = 0;
+
+		if ( children_tail == 0 ) {
+			children_head = child;
+		} else {
+			children_tail->next_sibling = child;
+		}
+
+		children_tail = child;
+		this->child_linked( child );
+	}
+
+	/*
+	 * Insert a Child
+	 *   void General_tree<Type>::tree_node :: insert_child( tree_node *child, tree_node *previous )
+	 *
+	 * Links the child immediately after the child previous
+	 * or, if previous is 0, first in the list of children,
+	 * updating the array of children if they are indexed.
+	 * No other metadata is updated.
+	 *
+	 * O(1) if the children are linked; O(degree) if they are indexed
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::insert_child( tree_node *child, tree_node *previous ) {
+		tree_node *next = ( previous == 0 ) ? children_head : previous->next_sibling;
+
+		child->parent = this;
+		child->previous_sibling = previous;
+		child->next_sibling = next;
+
+		if ( previous == 0 ) {
+			children_head = child;
+		} else {
+			previous->next_sibling = child;
+		}
+
+		if ( next == 0 ) {
+			children_tail = child;
+		} else {
+			next->previous_sibling = child;
+		}
+
+		this->child_linked( child );
+	}
+
+	/*
+	 * Unlink a Child
+	 *   void General_tree<Type>::tree_node :: unlink_child( tree_node *child )
+	 *
+	 * Removes the child from the list of children (and the
+	 * array of children if they are indexed) without
+	 * deleting it.  No other metadata is updated.
+	 *
+	 * O(1) if the children are linked; O(degree) if they are indexed
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::unlink_child( tree_node *child ) {
+		if ( child->next_sibling != 0 ) {
+			child->next_sibling->previous_sibling = child->previous_sibling;
+		} else {
+			children_tail = child->previous_sibling;
+		}
+
+		if ( child->previous_sibling != 0 ) {
+			child->previous_sibling->next_sibling = child->next_sibling;
+		} else {
+			children_head = child->next_sibling;
+		}
+
+		child->previous_sibling = 0;
+		child->next_sibling = 0;
+		this->child_unlinked( child );
+	}
+
+	/*
+	 * Update the Node
+	 *   void General_tree<Type>::tree_node :: update_node()
+	 *
+	 * Recomputes the stored hash and subtree aggregate (if
+	 * any) of the node from its object and its children.
+	 *
+	 * O(degree) if either is stored;  O(1) otherwise
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::update_node() {
+		this->update_hash();
+		this->update_aggregate();
+	}
+
+	/*
+	 * Update the Ancestors
+	 *   void General_tree<Type>::tree_node :: update_ancestors()
+	 *
+	 * Updates this node and then all of its strict ancestors
+	 * back to the root node.
+	 *
+	 * O(sum of the degrees of the node and its ancestors) if the
+	 * hash or a subtree aggregate is stored;  O(1) otherwise
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::update_ancestors() {
+		if ( Metadata::hash || tree_node::aggregated ) {
+			for ( tree_node *regress = this; regress != 0; regress = regress->parent ) {
+				regress->update_node();
+			}
+		}
+	}
+
+	/*
+	 * Recompute
+	 *   void General_tree<Type>::tree_node :: recompute()
+	 *
+	 * Recomputes the stored degree, height, size, hash and
+	 * aggregate of the node from its children, which must
+	 * already be up to date.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::recompute() {
+		int d = 0;
+		int h = 0;
+		int s = 1;
+
+		for ( tree_node *child = children_head; child != 0; child = child->next_sibling ) {
+			++d;
+
+			if ( Metadata::height ) {
+				h = std::max( h, child->height() + 1 );
+			}
+
+			if ( Metadata::size ) {
+				s += child->size();
+			}
+		}
+
+		this->set_degree( d );
+		this->set_height( h );
+		this->set_size( s );
+		update_node();
+	}
+
+	/*
+	 * Destroy
+	 *   void General_tree<Type>::tree_node :: destroy()
+	 *
+	 * Deletes the node or, if it is pooled, only calls its
+	 * destructor:  the block is freed by the tree.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::destroy() {
+		if ( pooled ) {
+			this->~tree_node();
+		} else {
+			delete this;
+		}
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::tree_node::clear() {
+		// The next sibling must be read before the child is deleted
+		for ( tree_node *child = children_head, *next; child != 0; child = next ) {
+			next = child->next_sibling;
+			child->clear();
+		}
+
+		destroy();
+	}
+
+/*
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::tree_node::find( Type const &obj ) {
+		return iterator();
+	}
+ */
+
+	/****************************************************
+	 * ************************************************ *
+	 * *             Iterator Definitions             * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::iterator::iterator():
+	current_node( 0 ),
+	parent_node( 0 ) {
+		// Empty constructor
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::iterator::iterator( tree_node *c, tree_node *p ):
+	current_node( c ),
+	parent_node( p ) {
+		// Empty constructor
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::parent() {
+		if ( current_node->parent_node == 0 ) {
+			assert( false );
+		}
+
+		return iterator( current_node->parent_node, current_node->parent_node->parent );
+	}
+
+	/*
+	 * Degree of a Tree Node
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::iterator :: degree() const
+	 *
+	 * Returns the degree (number of children) of the currently
+	 * referred to node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::iterator::degree() const {
+		return current_node->degree();
+	}
+
+	/*
+	 * Depth of a Tree Node
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::iterator :: depth() const
+	 *
+	 * Returns the depth of the currently referred to
+	 * node (the length of the path from the root
+	 * node to the current node).
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::iterator::depth() const {
+		return current_node->depth();
+	}
+
+	/*
+	 * Height of a Tree Node
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::iterator :: height() const
+	 *
+	 * Returns the height of the tree defined by the
+	 * currently referred to node and its descendants.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::iterator::height() const {
+		return current_node->height();
+	}
+
+	/*
+	 * Size of a Tree Node
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::iterator :: size() const
+	 *
+	 * Returns the size of (number of nodes within) the tree defined
+	 * by the currently referred to node and its descendants.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::iterator::size() const {
+		return current_node->size();
+	}
+
+	/*
+	 * Hash of a Tree Node
+	 *   std::size_t General_tree<Type>::iterator :: hash() const
+	 *
+	 * Returns the hash of the tree defined by the currently
+	 * referred to node and its descendants.
+	 *
+	 * O(1) if the hashes are stored;  O(size of the subtree) otherwise
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	std::size_t General_tree<Type, Metadata, Children, Aggregate>::iterator::hash() const {
+		return current_node->hash();
+	}
+
+	/*
+	 * Aggregate of a Tree Node
+	 *   aggregate_type General_tree<Type, Metadata, Children, Aggregate>::iterator :: aggregate() const
+	 *
+	 * Returns the subtree aggregate of the objects within the
+	 * tree defined by the currently referred to node and its
+	 * descendants.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::aggregate_type General_tree<Type, Metadata, Children, Aggregate>::iterator::aggregate() const {
+		return current_node->aggregate();
+	}
+
+	/*
+	 * Leaf Query
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::iterator :: leaf() const
+	 *
+	 * Returns true if the currently referred to tree node is
+	 * leaf node (no children), and false otherwise.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::iterator::leaf() const {
+		return current_node->children_head == 0;
+	}
+
+	/*
+	 * Root Query
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::iterator :: root() const
+	 *
+	 * Returns true if the currently referred to tree node is
+	 * root node, and false otherwise.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::iterator::root() const {
+		return current_node->parent == 0;
+	}
+
+	/*
+	 * Pre-order Rank
+	 *   int General_tree<Type>::iterator :: preorder_rank() const
+	 *
+	 * Returns the position (starting at 0 with the root node)
+	 * of the currently referred to node in a pre-order traversal
+	 * of the tree:  for each strict ancestor, one for the
+	 * ancestor itself plus the sizes of the subtrees of the
+	 * previous siblings of the child on the path to the node.
+	 *
+	 * O(h x d) where d is the maximum degree, if the sizes are stored
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::iterator::preorder_rank() const {
+		int rank = 0;
+
+		for ( tree_node *ptr = current_node; ptr->parent != 0; ptr = ptr->parent ) {
+			++rank;
+
+			for ( tree_node *sibling = ptr->previous_sibling; sibling != 0; sibling = sibling->previous_sibling ) {
+				rank += sibling->size();
+			}
+		}
+
+		return rank;
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::begin() {
+		return iterator( current_node->children_head, current_node );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::end() {
+		return iterator( 0, current_node );
+	}
+
+	/*
+	 * Access the kth Child
+	 *   iterator General_tree<Type>::iterator :: child( int k )
+	 *
+	 * Returns an iterator referring to the kth child (starting
+	 * at 0) of the currently referred to node, or end() if the
+	 * node has k or fewer children.
+	 *
+	 * O(1) if the children are indexed; O(k) otherwise
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::child( int k ) {
+		if ( k < 0 || ( Children::indexed && k >= current_node->child_count() ) ) {
+			return end();
+		}
+
+		return iterator( current_node->child( k ), current_node );
+	}
+
+	/*
+	 * Subtree Depth-first Traversing Iterator
+	 *   depth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator :: begin_depth()
+	 *
+	 * Returns a depth-first traversing iterator which initially
+	 * refers to the currently referred to node and which only
+	 * visits the nodes within the subtree defined by that node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::begin_depth() {
+		return depth_iterator( current_node );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::begin_depth( descend_predicate const &pred ) {
+		return depth_iterator( current_node, pred );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::end_depth() {
+		return depth_iterator();
+	}
+
+	/*
+	 * Subtree Breadth-first Traversing Iterator
+	 *   breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator :: begin_breadth()
+	 *
+	 * Returns a breadth-first traversing iterator which initially
+	 * refers to the currently referred to node and which only
+	 * visits the nodes within the subtree defined by that node.
+	 *
+	 * If a maximum depth is given, it is relative to the
+	 * currently referred to node.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::begin_breadth() {
+		return breadth_iterator( current_node );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::begin_breadth( descend_predicate const &pred ) {
+		return breadth_iterator( current_node, pred );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::begin_breadth( int max_depth ) {
+		return breadth_iterator(
+			current_node, descend_predicate(),
+			( max_depth > INT_MAX - current_node->depth() ) ? INT_MAX : current_node->depth() + max_depth
+		);
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::end_breadth() {
+		return breadth_iterator();
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator &General_tree<Type, Metadata, Children, Aggregate>::iterator::operator++() {
+		if ( current_node != 0 ) {
+			current_node = current_node->next_sibling;
+		}
+
+		return *this;
+	}
+
+	/*
+	 * Postincrement Step
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::iterator :: operator++( int )
+	 *
+	 * This function is similar to the Preincrement Step function;
+	 * however, an iterator referring to the original tree node
+	 * is returned.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator General_tree<Type, Metadata, Children, Aggregate>::iterator::operator++( int ) {
+		iterator copy = *this;
+
+		if ( current_node != 0 ) {
+			current_node = current_node->next_sibling;
+		}
+
+		return copy;
+	}
+
+	/*
+	 * Dereference Operator
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::iterator :: operator*() const
+	 *
+	 * Return a reference to the object stored in the node
+	 * currently referred to by this iterator.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	Type &General_tree<Type, Metadata, Children, Aggregate>::iterator::operator*() const {
+		return current_node->element;
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::iterator::operator==( iterator const &rhs ) const {
+		return ( current_node == rhs.current_node );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::iterator::operator!=( iterator const &rhs ) const {
+		return ( current_node != rhs.current_node );
+	}
+
+	/*
+	 * Insert a New Type as a Child of the Currently Referrred To Node
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::iterator :: insert( Type const &obj ) const
+	 *
+	 * For an object to be inserted into a node, a number of operations
+	 * must be performed:
+	 *   The object must be appended to the doubly linked list
+	 *   of children of the current node (and to the array of
+	 *   children if the children are indexed).
+	 *     - This new node is a leaf node with depth one greater
+	 *       than the depth of the current node.
+	 *   The degree of the referred to node must be incremented.
+	 *   If the current node was previously a leaf node, its height
+	 *   and the height of all of its ancestors must be updated.
+	 *   The size of this node and all of its ancestors must
+	 *   be incremented.
+	 *
+	 * Only the metadata stored under the metadata policy
+	 * is updated.  The update of the heights stops at the
+	 * first ancestor whose height is unchanged.
+	 *
+	 * The hash and subtree aggregate (if any) of the current
+	 * node and all of its ancestors must be updated.
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::iterator::insert( Type const &obj ) {
+		int child_depth = Metadata::depth ? current_node->depth() + 1 : 0;
+
+		bool was_leaf = ( current_node->children_head == 0 );
+
+		// Append the new tree node to the list of children
+		// (which is empty if the current node is a leaf node).
+		tree_node *child = new tree_node( obj, current_node, 0, 0, child_depth );
+		current_node->append_child( child );
+		shared_generation.fetch_add( 1, std::memory_order_relaxed );
+
+		if ( Metadata::degree ) {
+			current_node->set_degree( current_node->degree() + 1 );
+		}
+
+		if ( was_leaf && Metadata::height ) {
+			// Set the height to 1 and update all strict ancestors
+			// recursing back to the root node (the parent of which is 0).
+
+			current_node->set_height( 1 );
+
+			for (
+				tree_node *current = current_node, *regress = current_node->parent;
+				regress != 0 && regress->height() < current->height() + 1;
+				current = regress, regress = regress->parent
+			) {
+				regress->set_height( current->height() + 1 );
+			}
+		}
+
+		// Increment the size of the current node and all
+		// strict ancestors recursing back to the root node.
+
+		if ( Metadata::size ) {
+			for ( tree_node *regress = current_node; regress != 0; regress = regress->parent ) {
+				regress->set_size( regress->size() + 1 );
+			}
+		}
+
+		// The new child is the last child of the current node, so its
+		// aggregate is combined on the right;  a child of each strict
+		// ancestor changed, so their hashes and aggregates are recomputed.
+
+		current_node->append_aggregate( child );
+		current_node->update_hash();
+
+		if ( current_node->parent != 0 ) {
+			current_node->parent->update_ancestors();
+		}
+	}
+
+	/*
+	 * Update the Object Stored in the Currently Referred To Node
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::iterator :: update( Type const &obj )
+	 *
+	 * Replaces the object stored in the current node and
+	 * recomputes the hash and subtree aggregate (if any) of
+	 * the current node and of all of its ancestors.
+	 *
+	 * O(1) without a hash or subtree aggregate;  otherwise
+	 * O(sum of the degrees of the node and its ancestors)
+	 */
 
-			void insert( Type const &obj );
-			int search (Type const &obj, iterator itr);
-			int search_ ( Type const &obj, iterator itr);
-			void remove( Type const &obj, iterator itr);
-			//int remove_( Type const &obj, iterator itr);
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::iterator::update( Type const &obj ) {
+		current_node->element = obj;
+		current_node->update_ancestors();
+	}
 
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::iterator::search( Type const &obj, iterator itr) {
 
-			iterator &operator++();
-			iterator operator++( int );
-			Type &operator*();
-			bool operator==( iterator const &rhs ) const;
-			bool operator!=( iterator const &rhs ) const;
+		return search_(obj, itr);
 
-			iterator parent();
-			iterator begin();
-			iterator end();
+	}
 
-		private:
-			tree_node *current_node;
-			tree_node *parent_node;
-			iterator( tree_node *, tree_node * );
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::iterator::search_( Type const &obj, iterator itr) {
 
-		friend class General_tree;
-	};
+		int aux = 0;
+		
+		for (iterator child = itr.begin(); child != itr.end(); ++child) {
+			aux = search_(obj, child);
 
-	/****************************************************
-	 * ************************************************ *
-	 * *        Depth-first Traversal Iterator        * *
-	 * ************************************************ *
-	 ****************************************************/
+			if (aux == 1){
+				child = itr.end();
+			}
+		}
 
-	/****************************************************
-	 * Iterator Class
-	 *   class General_tree<Type> :: iterator
-	 *
-	 * Author: Douglas Wilhelm Harder
-	 * 2009-10-10
-	 *
-	 * ...
-	 ****************************************************/
+		if (aux == 0){
+			if (*itr == obj){
+				aux = 1;
+			} 
 
-	template <typename Type>
-	class General_tree<Type>::depth_iterator {
-		public:
-			depth_iterator();
-			~depth_iterator();
-			depth_iterator( depth_iterator const & );
-			depth_iterator &operator=( depth_iterator const & );
+		} 
 
-			int degree() const;
-			int depth() const;
-			int height() const;
-			int size() const;
-			bool leaf() const;
-			bool root() const;
+		return aux;
 
-			depth_iterator &operator++();
-			depth_iterator operator++( int );
-			Type &operator*();
-			bool operator==( depth_iterator const &rhs ) const;
-			bool operator!=( depth_iterator const &rhs ) const;
+	}
 
-		private:
-			class stack_node;
-			stack_node *stack_top;
-			depth_iterator( tree_node * );
 
-		friend class General_tree;
-	};
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::iterator::remove( Type const &obj, iterator itr) {
 
-	/****************************************************
-	 * Stack Node Class
-	 *   class General_tree<Type>::depth_iterator :: stack_node
-	 *
-	 * Author: Douglas Wilhelm Harder
-	 * 2009-10-10
-	 *
-	 * A node used to create a stack where each entry
-	 * of the stack stores:
-	 *   - A pointer to a tree node, and
-	 *   - A pointer to the next stack node.
-	 *
-	 * This stack is used for implementing a depth-
-	 * first traversal of the tree.
-	 ****************************************************/
+		// The next sibling is found before the child (which
+		// may itself be removed) is visited
+		for (iterator child = itr.begin(); child != itr.end(); ) {
+			iterator next = child;
+			++next;
+			remove(obj, child);
+			child = next;
+		}
 
-	template <typename Type>
-	class General_tree<Type>::depth_iterator::stack_node {
-		public:
-			tree_node *pointer;
-			stack_node *next;
-			stack_node( tree_node *, stack_node * );
-			stack_node( stack_node const & );
+		if (*itr == obj){
 
-		friend class General_tree<Type>::depth_iterator;
-	};
+			int altura;
+			int tamanho = Metadata::size ? itr.current_node->size() : 0;
 
-	/****************************************************
-	 * ************************************************ *
-	 * *       Breadth-first Traversal Iterator       * *
-	 * ************************************************ *
-	 ****************************************************/
 
-	/****************************************************
-	 * Iterator Class
-	 *   class General_tree<Type> :: iterator
-	 *
-	 * Author: Douglas Wilhelm Harder
-	 * 2009-10-10
-	 *
-	 * ...
-	 ****************************************************/
+			tree_node *pai = itr.parent_node;
 
-	template <typename Type>
-	class General_tree<Type>::breadth_iterator {
-		public:
-			breadth_iterator();
-			~breadth_iterator();
-			breadth_iterator( breadth_iterator const & );
-			breadth_iterator &operator=( breadth_iterator const & );
+			pai->unlink_child(itr.current_node);
 
-			int degree() const;
-			int depth() const;
-			int height() const;
-			int size() const;
-			bool leaf() const;
-			bool root() const;
+			if (Metadata::degree){
+				pai->set_degree(pai->degree() - 1);
+			}
 
-			breadth_iterator &operator++();
-			breadth_iterator operator++( int );
-			Type &operator*();
-			bool operator==( breadth_iterator const &rhs ) const;
-			bool operator!=( breadth_iterator const &rhs ) const;
+			if (Metadata::size){
+				for (tree_node * regress = pai; regress != 0; regress = regress->parent){
+	
+					regress->set_size(regress->size() - tamanho);
+				}
+			}
 
-		private:
-			class queue_node;
-			queue_node *queue_front;
-			queue_node *queue_back;
-			breadth_iterator( tree_node * );
+			if (Metadata::height){
+				// The height of the parent and of each ancestor is
+				// recomputed from all of its children until one is
+				// unchanged
+				for (tree_node * regress = pai; regress != 0; regress = regress->parent) {
 
-		friend class General_tree;
-	};
+					altura = 0;
 
-	/****************************************************
-	 * Queue Node Class
-	 *   class General_tree<Type>::breadth_iterator :: queue_node
-	 *
-	 * Author: Douglas Wilhelm Harder
-	 * 2009-10-10
-	 *
-	 * A node used to create a queue where each entry
-	 * of the queue stores:
-	 *   - A pointer to a tree node, and
-	 *   - A pointer to the next stack node.
-	 *
-	 * This queue is used for implementing a breadth-
-	 * first traversal of the tree.
-	 ****************************************************/
+					for (tree_node *i = regress->children_head; i != 0; i = i->next_sibling){
+						altura = std::max(altura, i->height() + 1);
+					}
 
-	template <typename Type>
-	class General_tree<Type>::breadth_iterator::queue_node {
-		public:
-			tree_node *pointer;
-			queue_node *next;
-			queue_node( tree_node *, queue_node * );
-			queue_node( queue_node const & );
+					if (altura == regress->height()) {
+						break;
+					}
 
-		friend class General_tree<Type>::breadth_iterator;
-	};
+					regress->set_height(altura);
+				}
+			}
+
+			pai->update_ancestors();
+
+			itr.current_node->clear();
+			shared_generation.fetch_add( 1, std::memory_order_relaxed );
+			shared_removals.fetch_add( 1, std::memory_order_relaxed );
+			return;
+		}
+
+	}
 
 	/****************************************************
 	 * ************************************************ *
-	 * *           General Tree Definitions           * *
+	 * *  Depth-first Traversal Iterator Definitions  * *
 	 * ************************************************ *
 	 ****************************************************/
 
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::depth_iterator():
+	stack(),
+	descend(),
+	children_skipped( false ) {
+		// Empty constructor
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::depth_iterator( tree_node *rt, descend_predicate const &pred ):
+	stack( 1, rt ),
+	descend( pred ),
+	children_skipped( false ) {
+		// Empty constructor
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::degree() const {
+		return stack.back()->degree();
+	}
+
 	/*
-	 * Destructor
-	 *   General_tree<Type> :: ~General_tree()
+	 * Depth of a Tree Node
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: depth() const
 	 *
-	 * Create a new tree node storing the object.
+	 * Returns the depth of the currently referred to
+	 * node (the length of the path from the root
+	 * node to the current node).
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	General_tree<Type>::General_tree( Type const &obj ):
-	root_node( new tree_node( obj, 0, 0, 0, 0 ) ) {
-		// Empty constructor
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::depth() const {
+		return stack.back()->depth();
 	}
 
 	/*
-	 * Destructor
-	 *   General_tree<Type> :: ~General_tree()
+	 * Height of a Tree Node
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: height() const
 	 *
-	 * Must recursively clear all objects within
-	 * the tree.
+	 * Returns the height of the tree defined by the
+	 * currently referred to node and its descendants.
 	 *
-	 * O(n)
+	 * O(1)
 	 */
 
-	template <typename Type>
-	General_tree<Type>::~General_tree() {
-		root_node->clear();
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::height() const {
+		return stack.back()->height();
 	}
 
 	/*
-	 * Empty
-	 *   bool General_tree<Type> :: empty() const
+	 * Size of a Tree Node
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: size() const
 	 *
-	 * Returns 'false':  there is always a root
-	 * node in the general tree.
+	 * Returns the size of (number of nodes within) the tree defined
+	 * by the currently referred to node and its descendants.
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	bool General_tree<Type>::empty() const {
-		return false;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::size() const {
+		return stack.back()->size();
 	}
 
 	/*
-	 * Size
-	 *   int General_tree<Type> :: size() const
+	 * Leaf Query
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: leaf() const
 	 *
-	 * Returns the number of nodes within the
-	 * general tree.
+	 * Returns true if the currently referred to tree node is
+	 * leaf node (no children), and false otherwise.
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::size() const {
-		return root_node->node_size;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::leaf() const {
+		return stack.back()->children_head == 0;
 	}
 
 	/*
-	 * Height
-	 *   int General_tree<Type> :: height() const
+	 * Root Query
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: root() const
 	 *
-	 * Returns the height of the general tree:
-	 * the lenght of the longest path from
-	 * the root node to a node within the tree.
+	 * Returns true if the currently referred to tree node is
+	 * root node, and false otherwise.
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::height() const {
-		return root_node->node_height;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::root() const {
+		return stack.back()->parent == 0;
 	}
 
 	/*
-	 * Clear
-	 *   void General_tree<Type> :: clear()
+	 * Skip Children
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: skip_children()
 	 *
-	 * Removes all nodes except for the root node.
+	 * The descendants of the currently referred to node will
+	 * not be visited:  the next increment only pops the
+	 * node off of the stack.
 	 *
-	 * O(n)
+	 * O(1)
 	 */
 
-	template <typename Type>
-	void General_tree<Type>::clear() {
-		for ( tree_node *child = root_node->children_head; child != 0; child = child->next_sibling ) {
-			child->clear();
-		}
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::skip_children() {
+		children_skipped = true;
 	}
 
 	/*
-	 * Explicit Iterator
-	 *   iterator General_tree<Type> :: begin()
+	 * Reserve
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: reserve( int n )
 	 *
-	 * Returns a explicit (programmer-directored) traversing
-	 * iterator which initially refers to the root node.
+	 * Pre-sizes the stack so that it may hold n entries
+	 * without being reallocated.  The stack never holds
+	 * more entries than the size of the subtree being
+	 * traversed.
 	 *
-	 * O(1)
+	 * O(n)
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::iterator General_tree<Type>::begin() {
-		return iterator( root_node, 0 );
-	}
-
-	template <typename Type>
-	typename General_tree<Type>::iterator General_tree<Type>::end() {
-		return iterator( 0, 0 );
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::reserve( int n ) {
+		if ( n > 0 ) {
+			stack.reserve( n );
+		}
 	}
 
 	/*
-	 * Depth-first Traversing Iterator
-	 *   iterator General_tree<Type> :: begin_depth()
+	 * Preincrement Step
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: operator++()
 	 *
-	 * Returns a depth-first traversing
-	 * iterator which initially refers to the root node.
+	 * A stack is used to facilitate a depth-first traversal.
+	 * The root node is pushed onto a stack and then we iterate:
+	 *   While the stack is not empty:
+	 *    - Pop the top of the stack, and
+	 *      Push all children onto the stack in reverse order.
+	 *
+	 * This function performs the pop operation together with
+	 * any necessary push operations,
+	 * Updates the iterator to refer to the tree node popped
+	 * off the stack, and
+	 * Returns a reference to this iterator.
+	 *
+	 * The children are not pushed if they are to be skipped.
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::breadth_iterator General_tree<Type>::begin_breadth() {
-		return breadth_iterator( root_node );
-	}
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator &General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::operator++() {
+		// We can only increment an interator which
+		// has not yet already completed.
+		if ( stack.empty() ) {
+			return *this;
+		}
 
-	template <typename Type>
-	typename General_tree<Type>::breadth_iterator General_tree<Type>::end_breadth() {
-		return breadth_iterator();
+		// Pop the top entry off of the stack
+		tree_node *top = stack.back();
+		stack.pop_back();
+
+		bool skip = children_skipped;
+		children_skipped = false;
+
+		if (
+			top->children_head == 0 || skip ||
+			( descend && !descend( iterator( top, top->parent ) ) )
+		) {
+			return *this;
+		}
+
+		// Push the children of the top entry onto the stack in reverse order
+		if ( Children::indexed ) {
+			tree_node * const *list = top->child_array();
+
+			for ( int k = top->child_count() - 1; k >= 0; --k ) {
+				stack.push_back( list[k] );
+			}
+		} else {
+			for ( tree_node *child = top->children_tail; child != 0; child = child->previous_sibling ) {
+				stack.push_back( child );
+			}
+		}
+
+		return *this;
 	}
 
 	/*
-	 * Breadth-first Traversing Iterator
-	 *   iterator General_tree<Type> :: begin_breadth()
+	 * Postincrement Step
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: operator++( int )
 	 *
-	 * Returns a breadth-first traversing
-	 * iterator which initially refers to the root node.
+	 * This function is similar to the Preincrement Step function;
+	 * however, an iterator referring to the original tree node
+	 * is returned.
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::depth_iterator General_tree<Type>::begin_depth() {
-		return depth_iterator( root_node );
-	}
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::depth_iterator General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::operator++( int ) {
+		depth_iterator copy = *this;
 
-	template <typename Type>
-	typename General_tree<Type>::depth_iterator General_tree<Type>::end_depth() {
-		return depth_iterator();
-	}
+		++(*this);
 
-	/****************************************************
-	 * ************************************************ *
-	 * *             Tree Node Definitions            * *
-	 * ************************************************ *
-	 ****************************************************/
+		return copy;
+	}
 
 	/*
-	 * Constructor
-	 *   iterator General_tree<Type>::tree_node :: tree_node( ... )
+	 * Dereference Operator
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator :: operator*() const
 	 *
-	 * Constructs a new tree node where:
-	 *   The object stored is specified.
-	 *   Pointers to the nodes containing the parent, previous
-	 *   sibling, and next sibling are specified.
-	 *   The list of children is initially empty
-	 *     - Children head and tail and the degree are set to 0
-	 *  The depth is specified.
-	 *  The height is 0 and the size is 1.
+	 * Return a reference to the object stored in the node
+	 * currently referred to by this iterator.
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	General_tree<Type>::tree_node::tree_node( Type const &obj, tree_node *par, tree_node *p, tree_node *n, int d ):
-	element( obj ),
-	parent( par ),
-	previous_sibling( p ),
-	next_sibling( n ),
-	children_head( 0 ),
-	children_tail( 0 ),
-	node_degree( 0 ),
-	node_depth( d ),
-	node_height( 0 ),
-	node_size( 1 ) {
-		// Empty constructor
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	Type &General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::operator*() const {
+		return stack.back()->element;
 	}
 
-	template <typename Type>
-	void General_tree<Type>::tree_node::clear() {
-		for ( tree_node *child = children_head; child != 0; child = child->next_sibling ) {
-			child->clear();
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::operator==( depth_iterator const &rhs ) const {
+		if ( stack.empty() || rhs.stack.empty() ) {
+			return stack.empty() == rhs.stack.empty();
+		} else {
+			return stack.back() == rhs.stack.back();
 		}
-
-		delete this;
 	}
 
-/*
-	template <typename Type>
-	typename General_tree<Type>::iterator General_tree<Type>::tree_node::find( Type const &obj ) {
-		return iterator();
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::depth_iterator::operator!=( depth_iterator const &rhs ) const {
+		return !( *this == rhs );
 	}
- */
 
 	/****************************************************
 	 * ************************************************ *
-	 * *             Iterator Definitions             * *
+	 * * Breadth-first Traversal Iterator Definitions * *
 	 * ************************************************ *
 	 ****************************************************/
 
-	template <typename Type>
-	General_tree<Type>::iterator::iterator():
-	current_node( 0 ),
-	parent_node( 0 ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::breadth_iterator():
+	queue(),
+	queue_front( 0 ),
+	descend(),
+	children_skipped( false ),
+	depth_limit( INT_MAX ) {
 		// Empty constructor
 	}
 
-	template <typename Type>
-	General_tree<Type>::iterator::iterator( tree_node *c, tree_node *p ):
-	current_node( c ),
-	parent_node( p ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::breadth_iterator( tree_node *rt, descend_predicate const &pred, int max_depth ):
+	queue( 1, rt ),
+	queue_front( 0 ),
+	descend( pred ),
+	children_skipped( false ),
+	depth_limit( max_depth ) {
 		// Empty constructor
 	}
 
-	template <typename Type>
-	typename General_tree<Type>::iterator General_tree<Type>::iterator::parent() {
-		if ( current_node->parent_node == 0 ) {
-			assert( false );
-		}
-
-		return iterator( current_node->parent_node, current_node->parent_node->parent );
-	}
-
-	/*
-	 * Degree of a Tree Node
-	 *   int General_tree<Type>::iterator :: degree() const
-	 *
-	 * Returns the degree (number of children) of the currently
-	 * referred to node.
-	 *
-	 * O(1)
-	 */
-
-	template <typename Type>
-	int General_tree<Type>::iterator::degree() const {
-		return current_node->node_degree;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::degree() const {
+		return queue[queue_front]->degree();
 	}
 
 	/*
 	 * Depth of a Tree Node
-	 *   int General_tree<Type>::iterator :: depth() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: depth() const
 	 *
 	 * Returns the depth of the currently referred to
 	 * node (the length of the path from the root
@@ -615,14 +3521,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::iterator::depth() const {
-		return current_node->node_depth;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::depth() const {
+		return queue[queue_front]->depth();
 	}
 
 	/*
 	 * Height of a Tree Node
-	 *   int General_tree<Type>::iterator :: height() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: height() const
 	 *
 	 * Returns the height of the tree defined by the
 	 * currently referred to node and its descendants.
@@ -630,14 +3536,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::iterator::height() const {
-		return current_node->node_height;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::height() const {
+		return queue[queue_front]->height();
 	}
 
 	/*
 	 * Size of a Tree Node
-	 *   int General_tree<Type>::iterator :: size() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: size() const
 	 *
 	 * Returns the size of (number of nodes within) the tree defined
 	 * by the currently referred to node and its descendants.
@@ -645,14 +3551,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::iterator::size() const {
-		return current_node->node_size;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::size() const {
+		return queue[queue_front]->size();
 	}
 
 	/*
 	 * Leaf Query
-	 *   bool General_tree<Type>::iterator :: leaf() const
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: leaf() const
 	 *
 	 * Returns true if the currently referred to tree node is
 	 * leaf node (no children), and false otherwise.
@@ -660,14 +3566,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	bool General_tree<Type>::iterator::leaf() const {
-		return current_node->children_head == 0;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::leaf() const {
+		return queue[queue_front]->children_head == 0;
 	}
 
 	/*
 	 * Root Query
-	 *   bool General_tree<Type>::iterator :: root() const
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: root() const
 	 *
 	 * Returns true if the currently referred to tree node is
 	 * root node, and false otherwise.
@@ -675,330 +3581,227 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	bool General_tree<Type>::iterator::root() const {
-		return current_node->parent == 0;
-	}
-
-	template <typename Type>
-	typename General_tree<Type>::iterator General_tree<Type>::iterator::begin() {
-		return iterator( current_node->children_head, current_node );
-	}
-
-	template <typename Type>
-	typename General_tree<Type>::iterator General_tree<Type>::iterator::end() {
-		return iterator( 0, current_node );
-	}
-
-	template <typename Type>
-	typename General_tree<Type>::iterator &General_tree<Type>::iterator::operator++() {
-		if ( current_node != 0 ) {
-			current_node = current_node->next_sibling;
-		}
-
-		return *this;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::root() const {
+		return queue[queue_front]->parent == 0;
 	}
 
 	/*
-	 * Postincrement Step
-	 *   bool General_tree<Type>::iterator :: operator++( int )
+	 * Skip Children
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: skip_children()
 	 *
-	 * This function is similar to the Preincrement Step function;
-	 * however, an iterator referring to the original tree node
-	 * is returned.
+	 * The descendants of the currently referred to node will
+	 * not be visited:  the next increment only pops the
+	 * node off of the queue.
 	 *
 	 * O(1)
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::iterator General_tree<Type>::iterator::operator++( int ) {
-		iterator copy = *this;
-
-		if ( current_node != 0 ) {
-			current_node = current_node->next_sibling;
-		}
-
-		return copy;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::skip_children() {
+		children_skipped = true;
 	}
 
 	/*
-	 * Dereference Operator
-	 *   bool General_tree<Type>::iterator :: operator*()
+	 * Reserve
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: reserve( int n )
 	 *
-	 * Return a reference to the object stored in the node
-	 * currently referred to by this iterator.
+	 * Pre-sizes the queue so that it may hold n entries
+	 * without being reallocated.  The queue never holds
+	 * more entries than the size of the subtree being
+	 * traversed.
 	 *
-	 * O(1)
+	 * O(n)
 	 */
 
-	template <typename Type>
-	Type &General_tree<Type>::iterator::operator*() {
-		return current_node->element;
-	}
-
-	template <typename Type>
-	bool General_tree<Type>::iterator::operator==( iterator const &rhs ) const {
-		return ( current_node == rhs.current_node );
-	}
-
-	template <typename Type>
-	bool General_tree<Type>::iterator::operator!=( iterator const &rhs ) const {
-		return ( current_node != rhs.current_node );
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::reserve( int n ) {
+		if ( n > 0 ) {
+			queue.reserve( n );
+		}
 	}
 
 	/*
-	 * Insert a New Type as a Child of the Currently Referrred To Node
-	 *   void General_tree<Type>::iterator :: insert( Type const &obj ) const
+	 * Preincrement Step
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: operator++()
 	 *
-	 * For an object to be inserted into a node, a number of operations
-	 * must be performed:
-	 *   The object must be appended to the doubly linked list
-	 *   of children of the current node.
-	 *     - This new node is a leaf node with depth one greater
-	 *       than the depth of the current node.
-	 *   The degree of the referred to node must be incremented.
-	 *   If the current node was previously a leaf node, its height
-	 *   and the height of all of its ancestors must be updated.
-	 *   The size of this node and all of its ancestors must
-	 *   be incremented.
+	 * A queue is used to facilitate a breadth-first traversal.
+	 * The root node is pushed onto a queue and then we iterate:
+	 *   While the queue is not empty:
+	 *     - Pop the front of the queue and
+	 *     - Push all children onto the queue.
+	 *
+	 * This function performs the pop operation together with
+	 * any necessary push operations,
+	 * Updates the iterator to refer to the tree node popped
+	 * off the queue, and
+	 * Returns a reference to this iterator.
+	 *
+	 * The children are not pushed if they are to be skipped
+	 * or if they are deeper than the maximum depth.
 	 *
+	 * The entries which have been popped are only removed
+	 * from the buffer once they make up more than half of
+	 * it, so each entry is moved at most once on average.
+	 *
+	 * If the children are linked, the node
+	 * GENERAL_TREE_PREFETCH_DISTANCE entries behind the front
+	 * of the queue is prefetched so that it is in the cache
+	 * once it reaches the front.  Indexed children are not
+	 * prefetched:  the children of a node are then copied from
+	 * one array and are usually already in the cache, so the
+	 * prefetch only adds instructions (see bench.cpp).
+	 *
+	 * O(1) amortized
 	 */
 
-	template <typename Type>
-	void General_tree<Type>::iterator::insert( Type const &obj ) {
-		if ( current_node->node_degree == 0 ) {
-			// If the current node is a leaf node, then
-			// a new node must be placed into the empty list
-			// of children.
-
-			current_node->children_head = new tree_node(
-				obj, current_node, 0, 0, current_node->node_depth + 1
-			);
-
-			current_node->children_tail = current_node->children_head;
-			current_node->node_degree = 1;
-
-			// Set the height to 1 and update all strict ancestors
-			// recursing back to the root node (the parent of which is 0).
-
-			current_node->node_height = 1;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator &General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::operator++() {
+		if ( queue_front == queue.size() ) {
+			return *this;
+		}
 
-			for (
-				tree_node *current = current_node, *regress = current_node->parent;
-				regress != 0;
-				current = regress, regress = regress->parent
-			) {
-				regress->node_height = std::max( current->node_height + 1, regress->node_height );
+		bool skip = children_skipped;
+		children_skipped = false;
+
+		tree_node *front = queue[queue_front];
+
+		if (
+			!skip && front->children_head != 0 &&
+			( depth_limit == INT_MAX || front->depth() < depth_limit ) &&
+			( !descend || descend( iterator( front, front->parent ) ) )
+		) {
+			// Push the children of the front entry onto the queue
+			if ( Children::indexed ) {
+				queue.insert( queue.end(), front->child_array(), front->child_array() + front->child_count() );
+			} else {
+				for ( tree_node *child = front->children_head; child != 0; child = child->next_sibling ) {
+					queue.push_back( child );
+				}
 			}
-
-			// The size must now be 2:  the current node and its 
-			current_node->node_size = 2;
-
-		} else {
-			// If the current node is not a leaf node, then
-			// append the new tree node to the currently existing
-			// list of children.
-			tree_node *tmp = new tree_node(
-				obj, current_node, current_node->children_tail, 0, current_node->node_depth + 1
-			);
-
-			current_node->children_tail->next_sibling = tmp;
-			current_node->children_tail = tmp;
-			++( current_node->node_degree );
-
-			// Increment the size of the current node
-			++( current_node->node_size );
 		}
 
-		// Increment the size of all strict ancestors
-		// recursing back to the root node.
+		// Pop the front entry off the queue
+		++queue_front;
 
-		for ( tree_node *regress = current_node->parent; regress != 0; regress = regress->parent ) {
-			++( regress->node_size );
+		// Request the node which is visited after the next few
+		if (
+			!Children::indexed && GENERAL_TREE_PREFETCH_DISTANCE > 0 &&
+			queue_front + GENERAL_TREE_PREFETCH_DISTANCE < queue.size()
+		) {
+			GENERAL_TREE_PREFETCH( queue[queue_front + GENERAL_TREE_PREFETCH_DISTANCE] );
 		}
-	}
-
-	template <typename Type>
-	int General_tree<Type>::iterator::search( Type const &obj, iterator itr) {
-			
-		int aux = search_(obj, itr);
 
-		if (aux == 0){
-			cout << "Nao esta presente na lista" << endl;
+		if ( queue_front == queue.size() ) {
+			queue.clear();
+			queue_front = 0;
+		} else if ( 2*queue_front > queue.size() ) {
+			queue.erase( queue.begin(), queue.begin() + queue_front );
+			queue_front = 0;
 		}
-	
-		return aux;
 
+		return *this;
 	}
 
-	template <typename Type>
-	int General_tree<Type>::iterator::search_( Type const &obj, iterator itr) {
-
-		int aux = 0;
-		
-		for (General_tree<int>::iterator child = itr.begin(); child != itr.end(); ++child) {
-			aux = search_(obj, child);
-
-			if (aux == 1){
-				child = itr.end();
-			}
-		}
-
-		if (aux == 0){
-			if (*itr == obj){
-				cout << "Esta presente na lista" << endl;
-				std::cout << *itr <<
-				"  (depth " << itr.depth() <<
-				", size " << itr.size() <<
-				", height " << itr.height() <<
-				", degree " << itr.degree() <<
-				", is root " << itr.root() <<
-				", is leaf " << itr.leaf() <<
-				")" << std::endl;
-				aux = 1;
-			} 
+	/*
+	 * Postincrement Step
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: operator++( int )
+	 *
+	 * This function is similar to the Preincrement Step function;
+	 * however, an iterator referring to the original tree node
+	 * is returned.
+	 *
+	 * O(1)
+	 */
 
-		} 
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::operator++( int ) {
+		breadth_iterator copy = *this;
 
-		return aux;
+		++(*this);
 
+		return copy;
 	}
 
+	/*
+	 * Dereference Operator
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator :: operator*() const
+	 *
+	 * Return a reference to the object stored in the node
+	 * currently referred to by this iterator.
+	 *
+	 * O(1)
+	 */
 
-	template <typename Type>
-	void General_tree<Type>::iterator::remove( Type const &obj, iterator itr) {
-
-		for (General_tree<int>::iterator child = itr.begin(); child != itr.end(); ++child) {
-			remove(obj, child);
-
-		}
-
-		if (*itr == obj){
-
-			int altura;
-			int tamanho = itr.current_node->node_size;
-
-
-			tree_node *temp = itr.current_node->next_sibling;
-			tree_node *temp2 = itr.current_node->previous_sibling;
-			tree_node *pai = itr.parent_node;
-
-			if (temp != NULL){
-					temp->previous_sibling = temp2;
-					cout << "Um" << endl;
-			}
-
-			if (temp2 != NULL){
-				temp2->next_sibling = temp;
-			}
-
-			if (pai->children_tail == itr.current_node){
-				pai->children_tail = temp2;
-			}
-
-			if (pai->children_head == itr.current_node){
-				pai->children_head = temp;
-			}
-
-			pai->node_degree = itr.parent_node->node_degree - 1;
-
-			for (tree_node * regress = pai; regress != 0; regress = regress->parent){
-	
-				regress->node_size = regress->node_size - tamanho;
-			}
-
-			if (pai->node_degree == 0){
-
-				pai->node_height = 0;
-			}
-
-			for (tree_node * regress = pai->parent; regress != 0; regress = regress->parent) {
-
-				altura = 0;
-
-				for (tree_node *i = regress->children_head; i != regress->children_tail; i = i->next_sibling){
-					altura = std::max(altura, i->node_height);
-				}
-
-				
-				regress->node_height = altura + 1;
-				
-			}
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	Type &General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::operator*() const {
+		return queue[queue_front]->element;
+	}
 
-			itr.current_node->clear();
-			cout << "No removido" << endl;
-			return;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::operator==( breadth_iterator const &rhs ) const {
+		if ( queue.empty() || rhs.queue.empty() ) {
+			return queue.empty() == rhs.queue.empty();
+		} else {
+			return queue[queue_front] == rhs.queue[rhs.queue_front];
 		}
+	}
 
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::breadth_iterator::operator!=( breadth_iterator const &rhs ) const {
+		return !( *this == rhs );
 	}
 
 	/****************************************************
 	 * ************************************************ *
-	 * *  Depth-first Traversal Iterator Definitions  * *
+	 * *   Post-order Traversal Iterator Definitions  * *
 	 * ************************************************ *
 	 ****************************************************/
 
-	template <typename Type>
-	General_tree<Type>::depth_iterator::depth_iterator():
-	stack_top( 0 ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::postorder_iterator():
+	current_node( 0 ),
+	root_node( 0 ) {
 		// Empty constructor
 	}
 
-	template <typename Type>
-	General_tree<Type>::depth_iterator::depth_iterator( tree_node *rt ):
-	stack_top( new stack_node( rt, 0 ) ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::postorder_iterator( tree_node *rt ):
+	current_node( first_leaf( rt ) ),
+	root_node( rt ) {
 		// Empty constructor
 	}
 
-	template <typename Type>
-	General_tree<Type>::depth_iterator::~depth_iterator() {
-		while ( stack_top != 0 ) {
-			stack_node *tmp = stack_top;
-			stack_top = stack_top->next;
-			delete tmp;
-		}
-	}
-
-	template <typename Type>
-	General_tree<Type>::depth_iterator::depth_iterator( depth_iterator const &itr ):
-	stack_top( 0 ) {
-		*this = itr;
-	}
-
-	template <typename Type>
-	typename General_tree<Type>::depth_iterator &General_tree<Type>::depth_iterator::operator=( depth_iterator const &rhs ) {
-		if ( this == &rhs ) {
-			return *this;
-		}
-
-		while ( stack_top != 0 ) {
-			stack_node *tmp = stack_top;
-			stack_top = stack_top->next;
-			delete tmp;
-		}
+	/*
+	 * First Leaf
+	 *   tree_node *General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: first_leaf( tree_node * )
+	 *
+	 * Returns the first node visited in a post-order traversal
+	 * of the subtree defined by the argument:  follow the
+	 * children head pointers until a leaf node is reached.
+	 *
+	 * O(h)
+	 */
 
-		if ( rhs.stack_top == 0 ) {
-			stack_top = 0;
-			return *this;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::tree_node *General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::first_leaf( tree_node *ptr ) {
+		if ( ptr != 0 ) {
+			while ( ptr->children_head != 0 ) {
+				ptr = ptr->children_head;
+			}
 		}
 
-		stack_top = new stack_node( *rhs.stack_top );
-		stack_node *lptr = stack_top;
-
-		for ( stack_node *rptr = rhs.stack_top->next; rptr != 0; rptr = rptr->next ) {
-			lptr->next = new stack_node( *rptr );
-			lptr = lptr->next;
-		}
+		return ptr;
 	}
 
-	template <typename Type>
-	int General_tree<Type>::depth_iterator::degree() const {
-		return stack_top->pointer->node_degree;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::degree() const {
+		return current_node->degree();
 	}
 
 	/*
 	 * Depth of a Tree Node
-	 *   int General_tree<Type>::depth_iterator :: depth() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: depth() const
 	 *
 	 * Returns the depth of the currently referred to
 	 * node (the length of the path from the root
@@ -1007,14 +3810,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::depth_iterator::depth() const {
-		return stack_top->pointer->node_depth;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::depth() const {
+		return current_node->depth();
 	}
 
 	/*
 	 * Height of a Tree Node
-	 *   int General_tree<Type>::depth_iterator :: height() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: height() const
 	 *
 	 * Returns the height of the tree defined by the
 	 * currently referred to node and its descendants.
@@ -1022,14 +3825,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::depth_iterator::height() const {
-		return stack_top->pointer->node_height;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::height() const {
+		return current_node->height();
 	}
 
 	/*
 	 * Size of a Tree Node
-	 *   int General_tree<Type>::depth_iterator :: size() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: size() const
 	 *
 	 * Returns the size of (number of nodes within) the tree defined
 	 * by the currently referred to node and its descendants.
@@ -1037,14 +3840,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::depth_iterator::size() const {
-		return stack_top->pointer->node_size;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::size() const {
+		return current_node->size();
 	}
 
 	/*
 	 * Leaf Query
-	 *   bool General_tree<Type>::depth_iterator :: leaf() const
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: leaf() const
 	 *
 	 * Returns true if the currently referred to tree node is
 	 * leaf node (no children), and false otherwise.
@@ -1052,14 +3855,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	bool General_tree<Type>::depth_iterator::leaf() const {
-		return stack_top->pointer->children_head == 0;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::leaf() const {
+		return current_node->children_head == 0;
 	}
 
 	/*
 	 * Root Query
-	 *   bool General_tree<Type>::depth_iterator :: root() const
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: root() const
 	 *
 	 * Returns true if the currently referred to tree node is
 	 * root node, and false otherwise.
@@ -1067,76 +3870,55 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	bool General_tree<Type>::depth_iterator::root() const {
-		return stack_top->pointer->parent == 0;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::root() const {
+		return current_node->parent == 0;
 	}
 
 	/*
 	 * Preincrement Step
-	 *   bool General_tree<Type>::depth_iterator :: operator++()
-	 *
-	 * A stack is used to facilitate a depth-first traversal.
-	 * The root node is pushed onto a stack and then we iterate:
-	 *   While the stack is not empty:
-	 *    - Pop the top of the stack, and
-	 *      Push all children onto the stack in reverse order.
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: operator++()
 	 *
-	 * This function performs the pop operation together with
-	 * any necessary push operations,
-	 * Updates the iterator to refer to the tree node popped
-	 * off the stack, and
-	 * Returns a reference to this iterator.
+	 * Once the root of the traversal has been visited, the
+	 * traversal is complete.  Otherwise:
+	 *   - if the current node has a next sibling, the next
+	 *     node is the first leaf of the subtree defined by
+	 *     that sibling, and
+	 *   - otherwise, all the children of the parent have been
+	 *     visited and the next node is the parent.
 	 *
-	 * O(1)
+	 * O(1) amortized over a complete traversal
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::depth_iterator &General_tree<Type>::depth_iterator::operator++() {
-		// We can only increment an interator which
-		// has not yet already completed.
-		if ( stack_top == 0 ) {
-			return *this;
-		}
-
-		// Pop the top stack_node off of the stack
-		stack_node *tmp = stack_top;
-		stack_top = stack_top->next;
-
-		if ( tmp->pointer->children_head == 0 ) {
-			delete tmp;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator &General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::operator++() {
+		if ( current_node == 0 ) {
 			return *this;
 		}
 
-		// Push the children of the top stack_node onto the stack in reverse order
-		stack_node *new_stack_top = new stack_node( tmp->pointer->children_head, stack_top );
-		stack_node *ptr = new_stack_top;
-
-		for ( tree_node *child = tmp->pointer->children_head->next_sibling; child != 0; child = child->next_sibling ) {
-			ptr->next = new stack_node( child, stack_top );
-			ptr = ptr->next;
+		if ( current_node == root_node ) {
+			current_node = 0;
+		} else if ( current_node->next_sibling != 0 ) {
+			current_node = first_leaf( current_node->next_sibling );
+		} else {
+			current_node = current_node->parent;
 		}
 
-		stack_top = new_stack_top;
-		delete tmp;
-
 		return *this;
 	}
 
 	/*
 	 * Postincrement Step
-	 *   bool General_tree<Type>::depth_iterator :: operator++( int )
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: operator++( int )
 	 *
 	 * This function is similar to the Preincrement Step function;
 	 * however, an iterator referring to the original tree node
 	 * is returned.
-	 *
-	 * O(1)
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::depth_iterator General_tree<Type>::depth_iterator::operator++( int ) {
-		depth_iterator copy = *this;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::operator++( int ) {
+		postorder_iterator copy = *this;
 
 		++(*this);
 
@@ -1145,7 +3927,7 @@ namespace Data_structures {
 
 	/*
 	 * Dereference Operator
-	 *   bool General_tree<Type>::depth_iterator :: operator*()
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator :: operator*() const
 	 *
 	 * Return a reference to the object stored in the node
 	 * currently referred to by this iterator.
@@ -1153,116 +3935,47 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	Type &General_tree<Type>::depth_iterator::operator*() {
-		return stack_top->pointer->element;
-	}
-
-	template <typename Type>
-	bool General_tree<Type>::depth_iterator::operator==( depth_iterator const &rhs ) const {
-		if ( stack_top == 0 || rhs.stack_top == 0 ) {
-			return stack_top == rhs.stack_top;
-		} else {
-			return stack_top->pointer == rhs.stack_top->pointer;
-		}
-	}
-
-	template <typename Type>
-	bool General_tree<Type>::depth_iterator::operator!=( depth_iterator const &rhs ) const {
-		if ( stack_top == 0 || rhs.stack_top == 0 ) {
-			return stack_top != rhs.stack_top;
-		} else {
-			return stack_top->pointer != rhs.stack_top->pointer;
-		}
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	Type &General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::operator*() const {
+		return current_node->element;
 	}
 
-	template <typename Type>
-	General_tree<Type>::depth_iterator::stack_node::stack_node( tree_node *p, stack_node *n ):
-	pointer( p ),
-	next( n ) {
-
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::operator==( postorder_iterator const &rhs ) const {
+		return ( current_node == rhs.current_node );
 	}
 
-	template <typename Type>
-	General_tree<Type>::depth_iterator::stack_node::stack_node( stack_node const &node ):
-	pointer( node.pointer ),
-	next( node.next ) {
-
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::postorder_iterator::operator!=( postorder_iterator const &rhs ) const {
+		return ( current_node != rhs.current_node );
 	}
 
 	/****************************************************
 	 * ************************************************ *
-	 * * Breadth-first Traversal Iterator Definitions * *
+	 * *   Pre-order Traversal Iterator Definitions   * *
 	 * ************************************************ *
 	 ****************************************************/
 
-	template <typename Type>
-	General_tree<Type>::breadth_iterator::breadth_iterator():
-	queue_front( 0 ),
-	queue_back( 0 ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::preorder_iterator():
+	current_node( 0 ) {
 		// Empty constructor
 	}
 
-	template <typename Type>
-	General_tree<Type>::breadth_iterator::breadth_iterator( tree_node *rt ):
-	queue_front( new queue_node( rt, 0 ) ),
-	queue_back( queue_front ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::preorder_iterator( tree_node *rt ):
+	current_node( rt ) {
 		// Empty constructor
 	}
 
-	template <typename Type>
-	General_tree<Type>::breadth_iterator::~breadth_iterator() {
-		while ( queue_front != 0 ) {
-			queue_node *tmp = queue_front;
-			queue_front = queue_front->next;
-			delete tmp;
-		}
-	}
-
-	template <typename Type>
-	General_tree<Type>::breadth_iterator::breadth_iterator( breadth_iterator const &itr ):
-	queue_front( 0 ),
-	queue_back( 0 ) {
-		*this = itr;
-	}
-
-	template <typename Type>
-	typename General_tree<Type>::breadth_iterator &General_tree<Type>::breadth_iterator::operator=( breadth_iterator const &rhs ) {
-		if ( this == &rhs ) {
-			return *this;
-		}
-
-		while ( queue_front != 0 ) {
-			queue_node *tmp = queue_front;
-			queue_front = queue_front->next;
-			delete tmp;
-		}
-
-		if ( rhs.queue_front == 0 ) {
-			queue_front = 0;
-			queue_back = 0;
-			return *this;
-		}
-
-		queue_front = new queue_node( *rhs.queue_front );
-		queue_node *lptr = queue_front;
-
-		for ( queue_node *rptr = rhs.queue_front->next; rptr != 0; rptr = rptr->next ) {
-			lptr->next = new queue_node( *rptr );
-			lptr = lptr->next;
-		}
-
-		queue_back = lptr;
-	}
-
-	template <typename Type>
-	int General_tree<Type>::breadth_iterator::degree() const {
-		return queue_front->pointer->node_degree;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::degree() const {
+		return current_node->degree();
 	}
 
 	/*
 	 * Depth of a Tree Node
-	 *   int General_tree<Type>::breadth_iterator :: depth() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: depth() const
 	 *
 	 * Returns the depth of the currently referred to
 	 * node (the length of the path from the root
@@ -1271,14 +3984,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::breadth_iterator::depth() const {
-		return queue_front->pointer->node_depth;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::depth() const {
+		return current_node->depth();
 	}
 
 	/*
 	 * Height of a Tree Node
-	 *   int General_tree<Type>::breadth_iterator :: height() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: height() const
 	 *
 	 * Returns the height of the tree defined by the
 	 * currently referred to node and its descendants.
@@ -1286,14 +3999,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::breadth_iterator::height() const {
-		return queue_front->pointer->node_height;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::height() const {
+		return current_node->height();
 	}
 
 	/*
 	 * Size of a Tree Node
-	 *   int General_tree<Type>::breadth_iterator :: size() const
+	 *   int General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: size() const
 	 *
 	 * Returns the size of (number of nodes within) the tree defined
 	 * by the currently referred to node and its descendants.
@@ -1301,14 +4014,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	int General_tree<Type>::breadth_iterator::size() const {
-		return queue_front->pointer->node_size;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::size() const {
+		return current_node->size();
 	}
 
 	/*
 	 * Leaf Query
-	 *   bool General_tree<Type>::breadth_iterator :: leaf() const
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: leaf() const
 	 *
 	 * Returns true if the currently referred to tree node is
 	 * leaf node (no children), and false otherwise.
@@ -1316,14 +4029,14 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	bool General_tree<Type>::breadth_iterator::leaf() const {
-		return queue_front->pointer->children_head == 0;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::leaf() const {
+		return current_node->children_head == 0;
 	}
 
 	/*
 	 * Root Query
-	 *   bool General_tree<Type>::breadth_iterator :: root() const
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: root() const
 	 *
 	 * Returns true if the currently referred to tree node is
 	 * root node, and false otherwise.
@@ -1331,64 +4044,74 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	bool General_tree<Type>::breadth_iterator::root() const {
-		return queue_front->pointer->parent == 0;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::root() const {
+		return current_node->parent == 0;
 	}
 
 	/*
-	 * Preincrement Step
-	 *   bool General_tree<Type>::breadth_iterator :: operator++()
+	 * Skip Subtree
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: skip_subtree()
 	 *
-	 * A queue is used to facilitate a breadth-first traversal.
-	 * The root node is pushed onto a queue and then we iterate:
-	 *   While the queue is not empty:
-	 *     - Pop the front of the queue and
-	 *     - Push all children onto the queue.
+	 * Moves the iterator to the first node following the
+	 * subtree defined by the currently referred to node:
+	 * the next sibling of the closest ancestor (including
+	 * the node itself) which has one.  If no such ancestor
+	 * exists, the traversal is complete.
 	 *
-	 * This function performs the pop operation together with
-	 * any necessary push operations,
-	 * Updates the iterator to refer to the tree node popped
-	 * off the queue, and
-	 * Returns a reference to this iterator.
+	 * O(h) in the worst case; O(1) amortized over a complete traversal
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::skip_subtree() {
+		while ( current_node != 0 && current_node->next_sibling == 0 ) {
+			current_node = current_node->parent;
+		}
+
+		if ( current_node != 0 ) {
+			current_node = current_node->next_sibling;
+		}
+	}
+
+	/*
+	 * Preincrement Step
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: operator++()
 	 *
-	 * O(1)
+	 * If the current node has children, the next node is
+	 * the first child;  otherwise, the subtree defined by
+	 * the current node (which is only the current node)
+	 * is skipped.
+	 *
+	 * O(1) amortized over a complete traversal
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::breadth_iterator &General_tree<Type>::breadth_iterator::operator++() {
-		if ( queue_front == 0 ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator &General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::operator++() {
+		if ( current_node == 0 ) {
 			return *this;
 		}
 
-		// Push the children of the front tree queue_node onto the queue
-		for ( tree_node *child = queue_front->pointer->children_head; child != 0; child = child->next_sibling ) {
-			queue_back->next = new queue_node( child, 0 );
-			queue_back = queue_back->next;
+		if ( current_node->children_head != 0 ) {
+			current_node = current_node->children_head;
+		} else {
+			skip_subtree();
 		}
 
-		// Pop the front queue_node off the queue
-		queue_node *tmp = queue_front;
-		queue_front = queue_front->next;
-		delete tmp;
-
 		return *this;
 	}
 
 	/*
 	 * Postincrement Step
-	 *   bool General_tree<Type>::breadth_iterator :: operator++( int )
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: operator++( int )
 	 *
 	 * This function is similar to the Preincrement Step function;
 	 * however, an iterator referring to the original tree node
 	 * is returned.
-	 *
-	 * O(1)
 	 */
 
-	template <typename Type>
-	typename General_tree<Type>::breadth_iterator General_tree<Type>::breadth_iterator::operator++( int ) {
-		breadth_iterator copy = *this;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::operator++( int ) {
+		preorder_iterator copy = *this;
 
 		++(*this);
 
@@ -1397,7 +4120,7 @@ namespace Data_structures {
 
 	/*
 	 * Dereference Operator
-	 *   bool General_tree<Type>::breadth_iterator :: operator*()
+	 *   bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator :: operator*() const
 	 *
 	 * Return a reference to the object stored in the node
 	 * currently referred to by this iterator.
@@ -1405,42 +4128,359 @@ namespace Data_structures {
 	 * O(1)
 	 */
 
-	template <typename Type>
-	Type &General_tree<Type>::breadth_iterator::operator*() {
-		return queue_front->pointer->element;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	Type &General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::operator*() const {
+		return current_node->element;
 	}
 
-	template <typename Type>
-	bool General_tree<Type>::breadth_iterator::operator==( breadth_iterator const &rhs ) const {
-		if ( queue_front == 0 || rhs.queue_front == 0 ) {
-			return queue_front == rhs.queue_front;
-		} else {
-			return queue_front->pointer == rhs.queue_front->pointer;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::operator==( preorder_iterator const &rhs ) const {
+		return ( current_node == rhs.current_node );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::preorder_iterator::operator!=( preorder_iterator const &rhs ) const {
+		return ( current_node != rhs.current_node );
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *            Transaction Definitions           * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::transaction_log::transaction_log( General_tree *t ):
+	tree( t ),
+	log() {
+		// Empty constructor
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::transaction_log::transaction_log( transaction_log &&other ):
+	tree( other.tree ),
+	log( std::move( other.log ) ) {
+		other.tree = 0;
+	}
+
+	/*
+	 * Destructor
+	 *   General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: ~transaction_log()
+	 *
+	 * Rolls back the transaction if it is still active.
+	 *
+	 * O(edits)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	General_tree<Type, Metadata, Children, Aggregate>::transaction_log::~transaction_log() {
+		if ( tree != 0 ) {
+			rollback();
 		}
 	}
 
-	template <typename Type>
-	bool General_tree<Type>::breadth_iterator::operator!=( breadth_iterator const &rhs ) const {
-		if ( queue_front == 0 || rhs.queue_front == 0 ) {
-			return queue_front != rhs.queue_front;
-		} else {
-			return queue_front->pointer != rhs.queue_front->pointer;
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	bool General_tree<Type, Metadata, Children, Aggregate>::transaction_log::active() const {
+		return ( tree != 0 );
+	}
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	int General_tree<Type, Metadata, Children, Aggregate>::transaction_log::edits() const {
+		return static_cast<int>( log.size() );
+	}
+
+	/*
+	 * Insert
+	 *   iterator General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: insert( iterator parent, Type const &obj )
+	 *
+	 * Appends a new child storing the object to the node referred
+	 * to by parent and returns an iterator referring to it.
+	 *
+	 * O(1) amortized (plus the depth of parent if depths are not stored)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	typename General_tree<Type, Metadata, Children, Aggregate>::iterator
+	General_tree<Type, Metadata, Children, Aggregate>::transaction_log::insert( iterator parent, Type const &obj ) {
+		assert( tree != 0 );
+
+		tree_node *par = parent.current_node;
+		tree_node *child = new tree_node( obj, par, 0, 0, Metadata::depth ? par->depth() + 1 : 0 );
+
+		undo_record entry = { inserted, child, par, 0 };
+		log.push_back( entry );
+
+		par->append_child( child );
+		++tree->structure_generation;
+
+		return iterator( child, par );
+	}
+
+	/*
+	 * Erase
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: erase( iterator itr )
+	 *
+	 * Unlinks the subtree defined by the node referred to by itr
+	 * (which must not be the root) from its parent.  The nodes are
+	 * deleted by commit().
+	 *
+	 * O(1) if the children are linked; O(degree) if they are indexed
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::transaction_log::erase( iterator itr ) {
+		assert( tree != 0 );
+
+		tree_node *node = itr.current_node;
+		tree_node *par = node->parent;
+
+		assert( par != 0 );
+
+		undo_record entry = { erased, node, par, node->previous_sibling };
+		log.push_back( entry );
+
+		par->unlink_child( node );
+		++tree->structure_generation;
+	}
+
+	/*
+	 * Splice
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: splice( iterator itr, iterator new_parent )
+	 *
+	 * Moves the subtree defined by the node referred to by itr
+	 * (which must not be the root) so that it becomes the last
+	 * child of the node referred to by new_parent, which must
+	 * not be within the subtree.
+	 *
+	 * O(depth of new_parent), plus the size of the subtree if
+	 * depths are stored
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::transaction_log::splice( iterator itr, iterator new_parent ) {
+		assert( tree != 0 );
+
+		tree_node *node = itr.current_node;
+		tree_node *par = node->parent;
+		tree_node *destination = new_parent.current_node;
+
+		assert( par != 0 );
+
+		for ( tree_node *regress = destination; regress != 0; regress = regress->parent ) {
+			assert( regress != node );
+		}
+
+		undo_record entry = { spliced, node, par, node->previous_sibling };
+		log.push_back( entry );
+
+		int old_depth = Metadata::depth ? node->depth() : 0;
+
+		par->unlink_child( node );
+		destination->append_child( node );
+		++tree->structure_generation;
+
+		if ( Metadata::depth ) {
+			shift_depth( node, destination->depth() + 1 - old_depth );
 		}
 	}
 
-	template <typename Type>
-	General_tree<Type>::breadth_iterator::queue_node::queue_node( tree_node *p, queue_node *n ):
-	pointer( p ),
-	next( n ) { 
+	/*
+	 * Commit
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: commit()
+	 *
+	 * Keeps the edits, recomputes the metadata of each node
+	 * whose children changed and of all of their ancestors,
+	 * deletes the erased subtrees and ends the transaction.
+	 *
+	 * Each affected node is counted once, by walking up from
+	 * each former or new parent until an affected node is
+	 * reached, together with the number of its children which
+	 * are affected.  The nodes with none are recomputed first
+	 * and each node is recomputed once all of its affected
+	 * children have been.  The ancestors of a node with many
+	 * edits below it are therefore recomputed only once.
+	 * This is faster than editing through the iterators if
+	 * the edits share ancestors or a hash or aggregate is
+	 * stored;  a few edits scattered over a tree storing only
+	 * the degree, height and size may be slower, as the
+	 * affected nodes are found with a hash table.
+	 *
+	 * O(edits + sum of the degrees of the affected nodes + sizes
+	 * of the erased subtrees)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::transaction_log::commit() {
+		assert( tree != 0 );
+
+		typedef std::unordered_map<tree_node *, affected_node> affected_map;
+
+		affected_map affected;
+		std::vector<affected_node *> ready;
+
+		affected.reserve( 4*log.size() );
+
+		for ( std::size_t k = 0; k < log.size(); ++k ) {
+			tree_node *touched[2] = { log[k].parent, log[k].kind == spliced ? log[k].node->parent : 0 };
+
+			for ( int i = 0; i < 2 && touched[i] != 0; ++i ) {
+				affected_node entry = { touched[i], 0, 0 };
+				std::pair<typename affected_map::iterator, bool> found = affected.insert( std::make_pair( touched[i], entry ) );
+
+				// Walk up until an ancestor which is already affected is reached
+				for ( affected_node *current = &found.first->second; found.second && current->node->parent != 0; current = current->parent ) {
+					affected_node up = { current->node->parent, 0, 0 };
+					found = affected.insert( std::make_pair( up.node, up ) );
+
+					current->parent = &found.first->second;
+					++current->parent->pending;
+				}
+			}
+		}
+
+		for ( typename affected_map::iterator itr = affected.begin(); itr != affected.end(); ++itr ) {
+			if ( itr->second.pending == 0 ) {
+				ready.push_back( &itr->second );
+			}
+		}
+
+		while ( !ready.empty() ) {
+			affected_node *current = ready.back();
+			ready.pop_back();
+
+			current->node->recompute();
+
+			if ( current->parent != 0 && --current->parent->pending == 0 ) {
+				ready.push_back( current->parent );
+			}
+		}
+
+		for ( std::size_t k = 0; k < log.size(); ++k ) {
+			if ( log[k].kind == erased ) {
+				discard( log[k].node );
+			}
+		}
+
+		++tree->structure_generation;
+		++tree->removal_generation;
+		log.clear();
+		tree = 0;
 	}
 
+	/*
+	 * Rollback
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: rollback()
+	 *
+	 * Undoes the edits in the reverse order and ends the
+	 * transaction:  each new node is unlinked and deleted,
+	 * and each erased or moved subtree is linked back after
+	 * its former previous sibling.  As the metadata of the
+	 * ancestors was never updated, nothing is recomputed.
+	 *
+	 * O(edits), plus the sizes of the moved subtrees if depths
+	 * are stored
+	 */
 
-	template <typename Type>
-	General_tree<Type>::breadth_iterator::queue_node::queue_node( queue_node const &node ):
-	pointer( node.pointer ),
-	next( node.next ) {
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::transaction_log::rollback() {
+		assert( tree != 0 );
+
+		while ( !log.empty() ) {
+			undo_record entry = log.back();
+			log.pop_back();
+
+			switch ( entry.kind ) {
+				case inserted:
+					entry.parent->unlink_child( entry.node );
+					entry.node->destroy();
+					break;
+				case erased:
+					entry.parent->insert_child( entry.node, entry.previous );
+					break;
+				case spliced: {
+					int old_depth = Metadata::depth ? entry.node->depth() : 0;
+
+					entry.node->parent->unlink_child( entry.node );
+					entry.parent->insert_child( entry.node, entry.previous );
+
+					if ( Metadata::depth ) {
+						shift_depth( entry.node, entry.parent->depth() + 1 - old_depth );
+					}
+
+					break;
+				}
+			}
+		}
+
+		++tree->structure_generation;
+		++tree->removal_generation;
+		tree = 0;
+	}
+
+	/*
+	 * Shift the Depths
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: shift_depth( tree_node *node, int delta )
+	 *
+	 * Adds delta to the stored depth of every node in the
+	 * subtree of the node, walking it in pre-order by following
+	 * the links of the nodes.
+	 *
+	 * O(size of the subtree)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::transaction_log::shift_depth( tree_node *node, int delta ) {
+		if ( delta == 0 ) {
+			return;
+		}
+
+		for ( tree_node *current = node; current != 0; ) {
+			current->set_depth( current->depth() + delta );
+
+			if ( current->children_head != 0 ) {
+				current = current->children_head;
+			} else {
+				while ( current != node && current->next_sibling == 0 ) {
+					current = current->parent;
+				}
 
+				current = ( current == node ) ? 0 : current->next_sibling;
+			}
+		}
+	}
+
+	/*
+	 * Discard
+	 *   void General_tree<Type, Metadata, Children, Aggregate>::transaction_log :: discard( tree_node *node )
+	 *
+	 * Deletes every node in the subtree of the node using an
+	 * explicit stack.
+	 *
+	 * O(size of the subtree)
+	 */
+
+	template <typename Type, typename Metadata, typename Children, typename Aggregate>
+	void General_tree<Type, Metadata, Children, Aggregate>::transaction_log::discard( tree_node *node ) {
+		std::vector<tree_node *> doomed( 1, node );
+
+		while ( !doomed.empty() ) {
+			tree_node *victim = doomed.back();
+			doomed.pop_back();
+
+			for ( tree_node *child = victim->children_head; child != 0; child = child->next_sibling ) {
+				doomed.push_back( child );
+			}
+
+			victim->destroy();
+		}
 	}
 }
 
+#if __cplusplus >= 202002L
+// The iterators of a traversal range refer into the tree and not
+// into the range, so they remain valid after the range is destroyed
+template <typename Iterator>
+inline constexpr bool std::ranges::enable_borrowed_range<Data_structures::traversal_range<Iterator> > = true;
+#endif
+
 #endif
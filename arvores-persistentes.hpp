@@ -0,0 +1,705 @@
+#ifndef DATA_STRUCTURES_PERSISTENT_TREE
+#define DATA_STRUCTURES_PERSISTENT_TREE
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *               Persistent Tree                * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Persistent Tree Class
+	 *   class Persistent_tree<Type>
+	 *
+	 * A general tree with the same ordering as General_tree
+	 * of which every copy is an independent version:  copying
+	 * a tree is O(1) and modifying one version never changes
+	 * another, so a copy is a point-in-time snapshot.
+	 *
+	 * The nodes are immutable and shared between versions.
+	 * insert(), erase() and update() copy only the nodes on
+	 * the path from the root to the node which changes, each
+	 * copy sharing all other children of the original, and
+	 * the version then refers to the new root.  Each node
+	 * stores the size and height of its subtree, so size()
+	 * and height() are O(1) in every version.
+	 *
+	 * A node stores its children in an array and is not
+	 * linked to its parent, as it may have a different parent
+	 * in each version.  Iterators therefore carry the path of
+	 * nodes from the root together with the position of each
+	 * within the children of its parent.
+	 *
+	 * The nodes are reference counted:  a node is deleted
+	 * once no version and no other node refers to it, so the
+	 * memory used is that of the newest version plus O(depth)
+	 * nodes for each change which is still visible in an older
+	 * version.  The counts are atomic, so different versions
+	 * may be read, copied and destroyed in different threads;
+	 * a single version may only be modified by one thread
+	 * while no other thread uses it.
+	 *
+	 * An iterator remains valid until the version from which
+	 * it was obtained is modified or destroyed.
+	 ****************************************************/
+
+	template <typename Type>
+	class Persistent_tree {
+		public:
+			class iterator;
+			class depth_iterator;
+
+			explicit Persistent_tree( Type const &obj = Type() );
+			Persistent_tree( Persistent_tree const & );
+			~Persistent_tree();
+
+			Persistent_tree &operator=( Persistent_tree const & );
+
+			bool empty() const;
+			int size() const;
+			int height() const;
+
+			iterator begin() const;
+			iterator end() const;
+
+			depth_iterator begin_depth() const;
+			depth_iterator end_depth() const;
+
+			iterator insert( iterator parent, Type const &obj );
+			int erase( iterator itr );
+			void update( iterator itr, Type const &obj );
+
+		private:
+			struct persistent_node {
+				Type element;
+				int size;
+				int height;
+				std::atomic<int> references;
+				std::vector<persistent_node *> children;
+
+				explicit persistent_node( Type const & );
+			};
+
+			// One step of the path of an iterator
+			struct path_step {
+				persistent_node *node;
+				int position;
+			};
+
+			persistent_node *root_node;
+
+			static persistent_node *copy( persistent_node const *, Type const & );
+			static void measure( persistent_node * );
+			static void release( persistent_node * );
+			iterator replace( iterator const &, persistent_node * );
+
+		friend class iterator;
+		friend class depth_iterator;
+	};
+
+	/****************************************************
+	 * Persistent Tree Iterator Class
+	 *   class Persistent_tree<Type> :: iterator
+	 *
+	 * An explicit iterator which stores the path from the
+	 * root to the node to which it refers.  Incrementing the
+	 * iterator moves to the next sibling;  parent() removes
+	 * the last step of the path.
+	 ****************************************************/
+
+	template <typename Type>
+	class Persistent_tree<Type>::iterator {
+		public:
+			iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+			bool root() const;
+
+			Type const &operator*() const;
+			iterator &operator++();
+			iterator operator++( int );
+			bool operator==( iterator const &rhs ) const;
+			bool operator!=( iterator const &rhs ) const;
+
+			iterator parent() const;
+			iterator begin() const;
+			iterator end() const;
+			iterator child( int k ) const;
+
+		private:
+			std::vector<path_step> path;
+
+			explicit iterator( persistent_node * );
+
+		friend class Persistent_tree;
+	};
+
+	/****************************************************
+	 * Persistent Tree Depth-first Traversal Iterator Class
+	 *   class Persistent_tree<Type> :: depth_iterator
+	 *
+	 * Visits each node of a version once in a depth-first
+	 * traversal order using a stack of the nodes yet to be
+	 * visited together with their depths.
+	 ****************************************************/
+
+	template <typename Type>
+	class Persistent_tree<Type>::depth_iterator {
+		public:
+			depth_iterator();
+
+			int degree() const;
+			int depth() const;
+			int height() const;
+			int size() const;
+			bool leaf() const;
+
+			Type const &operator*() const;
+			depth_iterator &operator++();
+			depth_iterator operator++( int );
+			bool operator==( depth_iterator const &rhs ) const;
+			bool operator!=( depth_iterator const &rhs ) const;
+
+		private:
+			std::vector<path_step> stack;
+
+			explicit depth_iterator( persistent_node * );
+
+		friend class Persistent_tree;
+	};
+
+	/****************************************************
+	 * ************************************************ *
+	 * *         Persistent Tree Definitions          * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Persistent_tree<Type>::persistent_node::persistent_node( Type const &obj ):
+	element( obj ),
+	size( 1 ),
+	height( 0 ),
+	references( 1 ),
+	children() {
+		// Empty constructor
+	}
+
+	/*
+	 * Constructors
+	 *   Persistent_tree<Type> :: Persistent_tree( Type const &obj )
+	 *   Persistent_tree<Type> :: Persistent_tree( Persistent_tree const &tree )
+	 *
+	 * Create a version whose root node stores the object, or
+	 * a snapshot of another version sharing its root.
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	Persistent_tree<Type>::Persistent_tree( Type const &obj ):
+	root_node( new persistent_node( obj ) ) {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Persistent_tree<Type>::Persistent_tree( Persistent_tree const &tree ):
+	root_node( tree.root_node ) {
+		root_node->references.fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	/*
+	 * Destructor
+	 *   Persistent_tree<Type> :: ~Persistent_tree()
+	 *
+	 * Releases the root:  the nodes which are used by no
+	 * other version are deleted.
+	 *
+	 * O(number of nodes deleted)
+	 */
+
+	template <typename Type>
+	Persistent_tree<Type>::~Persistent_tree() {
+		release( root_node );
+	}
+
+	template <typename Type>
+	Persistent_tree<Type> &Persistent_tree<Type>::operator=( Persistent_tree const &rhs ) {
+		rhs.root_node->references.fetch_add( 1, std::memory_order_relaxed );
+		release( root_node );
+		root_node = rhs.root_node;
+
+		return *this;
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::empty() const {
+		return false;
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::size() const {
+		return root_node->size;
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::height() const {
+		return root_node->height;
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::begin() const {
+		return iterator( root_node );
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::end() const {
+		return iterator();
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::depth_iterator Persistent_tree<Type>::begin_depth() const {
+		return depth_iterator( root_node );
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::depth_iterator Persistent_tree<Type>::end_depth() const {
+		return depth_iterator();
+	}
+
+	/*
+	 * Insert
+	 *   iterator Persistent_tree<Type> :: insert( iterator parent, Type const &obj )
+	 *
+	 * Appends a new child storing the object to a copy of the
+	 * node referred to by parent, copies its ancestors and
+	 * returns an iterator referring to the new child.
+	 *
+	 * O(sum of the degrees of the node and its ancestors)
+	 */
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::insert( iterator parent, Type const &obj ) {
+		persistent_node const *original = parent.path.back().node;
+		persistent_node *node = copy( original, original->element );
+
+		node->children.push_back( new persistent_node( obj ) );
+		measure( node );
+
+		return replace( parent, node ).child( node->children.size() - 1 );
+	}
+
+	/*
+	 * Erase
+	 *   int Persistent_tree<Type> :: erase( iterator itr )
+	 *
+	 * Copies the parent of the node referred to by itr (which
+	 * must not be the root) without that child, copies the
+	 * ancestors and returns the number of nodes in the subtree
+	 * of the node.  The subtree is deleted unless it is used
+	 * by another version.
+	 *
+	 * O(sum of the degrees of the ancestors of the node)
+	 */
+
+	template <typename Type>
+	int Persistent_tree<Type>::erase( iterator itr ) {
+		assert( itr.path.size() > 1 );
+
+		int removed = itr.path.back().node->size;
+		int k = itr.path.back().position;
+
+		itr.path.pop_back();
+
+		persistent_node const *original = itr.path.back().node;
+		persistent_node *node = copy( original, original->element );
+
+		release( node->children[k] );
+		node->children.erase( node->children.begin() + k );
+		measure( node );
+
+		replace( itr, node );
+
+		return removed;
+	}
+
+	/*
+	 * Update
+	 *   void Persistent_tree<Type> :: update( iterator itr, Type const &obj )
+	 *
+	 * Replaces the node referred to by itr with a copy storing
+	 * the object and copies its ancestors.
+	 *
+	 * O(sum of the degrees of the node and its ancestors)
+	 */
+
+	template <typename Type>
+	void Persistent_tree<Type>::update( iterator itr, Type const &obj ) {
+		persistent_node *node = copy( itr.path.back().node, obj );
+
+		measure( node );
+		replace( itr, node );
+	}
+
+	/*
+	 * Copy a Node
+	 *   persistent_node *Persistent_tree<Type> :: copy( persistent_node const *node, Type const &obj )
+	 *
+	 * Returns a new node storing the object which shares the
+	 * children of the node.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Type>
+	typename Persistent_tree<Type>::persistent_node *Persistent_tree<Type>::copy( persistent_node const *node, Type const &obj ) {
+		persistent_node *result = new persistent_node( obj );
+		result->children = node->children;
+
+		for ( std::size_t k = 0; k < result->children.size(); ++k ) {
+			result->children[k]->references.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		return result;
+	}
+
+	/*
+	 * Measure a Node
+	 *   void Persistent_tree<Type> :: measure( persistent_node *node )
+	 *
+	 * Sets the size and height of a new node from those of
+	 * its children.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Type>
+	void Persistent_tree<Type>::measure( persistent_node *node ) {
+		node->size = 1;
+		node->height = 0;
+
+		for ( std::size_t k = 0; k < node->children.size(); ++k ) {
+			node->size += node->children[k]->size;
+			node->height = std::max( node->height, node->children[k]->height + 1 );
+		}
+	}
+
+	/*
+	 * Replace a Node
+	 *   iterator Persistent_tree<Type> :: replace( iterator const &itr, persistent_node *node )
+	 *
+	 * Makes the new node, with a reference count of one, take
+	 * the place of the node referred to by itr:  each ancestor
+	 * is copied, from the parent up to the root, with the child
+	 * on the path replaced by the previous copy, and the version
+	 * then refers to the new root.  The old root is released.
+	 * Returns an iterator referring to the new node.
+	 *
+	 * O(sum of the degrees of the ancestors)
+	 */
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::replace( iterator const &itr, persistent_node *node ) {
+		iterator result = itr;
+		result.path.back().node = node;
+
+		for ( std::size_t j = result.path.size() - 1; j > 0; --j ) {
+			persistent_node const *original = result.path[j - 1].node;
+			persistent_node *ancestor = copy( original, original->element );
+			int k = result.path[j].position;
+
+			// The copy holds a reference to the old child in its place
+			release( ancestor->children[k] );
+			ancestor->children[k] = result.path[j].node;
+			measure( ancestor );
+
+			result.path[j - 1].node = ancestor;
+		}
+
+		release( root_node );
+		root_node = result.path.front().node;
+
+		return result;
+	}
+
+	/*
+	 * Release a Node
+	 *   void Persistent_tree<Type> :: release( persistent_node *node )
+	 *
+	 * Decrements the reference count of the node and, if it
+	 * becomes zero, deletes the node and releases its children
+	 * in turn, using an explicit stack.
+	 *
+	 * O(number of nodes deleted)
+	 */
+
+	template <typename Type>
+	void Persistent_tree<Type>::release( persistent_node *node ) {
+		std::vector<persistent_node *> stack( 1, node );
+
+		while ( !stack.empty() ) {
+			persistent_node *victim = stack.back();
+			stack.pop_back();
+
+			if ( victim->references.fetch_sub( 1, std::memory_order_acq_rel ) == 1 ) {
+				stack.insert( stack.end(), victim->children.begin(), victim->children.end() );
+				delete victim;
+			}
+		}
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *             Iterator Definitions             * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Persistent_tree<Type>::iterator::iterator():
+	path() {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Persistent_tree<Type>::iterator::iterator( persistent_node *rt ):
+	path() {
+		path_step step = { rt, 0 };
+		path.push_back( step );
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::iterator::degree() const {
+		return static_cast<int>( path.back().node->children.size() );
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::iterator::depth() const {
+		return static_cast<int>( path.size() ) - 1;
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::iterator::height() const {
+		return path.back().node->height;
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::iterator::size() const {
+		return path.back().node->size;
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::iterator::leaf() const {
+		return path.back().node->children.empty();
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::iterator::root() const {
+		return path.size() == 1;
+	}
+
+	template <typename Type>
+	Type const &Persistent_tree<Type>::iterator::operator*() const {
+		return path.back().node->element;
+	}
+
+	/*
+	 * Increment
+	 *   iterator &Persistent_tree<Type>::iterator :: operator++()
+	 *
+	 * Moves to the next child of the parent, or to the end
+	 * if there is none (or this is the root).
+	 *
+	 * O(1)
+	 */
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator &Persistent_tree<Type>::iterator::operator++() {
+		if ( path.size() == 1 ) {
+			path.clear();
+		} else {
+			std::vector<persistent_node *> const &siblings = path[path.size() - 2].node->children;
+			int k = path.back().position + 1;
+
+			if ( k < static_cast<int>( siblings.size() ) ) {
+				path.back().node = siblings[k];
+				path.back().position = k;
+			} else {
+				path.clear();
+			}
+		}
+
+		return *this;
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::iterator::operator++( int ) {
+		iterator copy = *this;
+		++( *this );
+
+		return copy;
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::iterator::operator==( iterator const &rhs ) const {
+		if ( path.empty() || rhs.path.empty() ) {
+			return path.empty() && rhs.path.empty();
+		}
+
+		return path.back().node == rhs.path.back().node;
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::iterator::operator!=( iterator const &rhs ) const {
+		return !( *this == rhs );
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::iterator::parent() const {
+		iterator result = *this;
+		result.path.pop_back();
+
+		return result;
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::iterator::begin() const {
+		return leaf() ? iterator() : child( 0 );
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::iterator::end() const {
+		return iterator();
+	}
+
+	/*
+	 * Child
+	 *   iterator Persistent_tree<Type>::iterator :: child( int k ) const
+	 *
+	 * Returns an iterator referring to the kth child, or the
+	 * end if there is none.
+	 *
+	 * O(depth) to copy the path
+	 */
+
+	template <typename Type>
+	typename Persistent_tree<Type>::iterator Persistent_tree<Type>::iterator::child( int k ) const {
+		if ( k < 0 || k >= degree() ) {
+			return iterator();
+		}
+
+		iterator result = *this;
+		path_step step = { path.back().node->children[k], k };
+		result.path.push_back( step );
+
+		return result;
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *      Depth-first Traversal Definitions       * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	template <typename Type>
+	Persistent_tree<Type>::depth_iterator::depth_iterator():
+	stack() {
+		// Empty constructor
+	}
+
+	template <typename Type>
+	Persistent_tree<Type>::depth_iterator::depth_iterator( persistent_node *rt ):
+	stack() {
+		path_step step = { rt, 0 };
+		stack.push_back( step );
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::depth_iterator::degree() const {
+		return static_cast<int>( stack.back().node->children.size() );
+	}
+
+	// The position of a step on the stack holds the depth
+	template <typename Type>
+	int Persistent_tree<Type>::depth_iterator::depth() const {
+		return stack.back().position;
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::depth_iterator::height() const {
+		return stack.back().node->height;
+	}
+
+	template <typename Type>
+	int Persistent_tree<Type>::depth_iterator::size() const {
+		return stack.back().node->size;
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::depth_iterator::leaf() const {
+		return stack.back().node->children.empty();
+	}
+
+	template <typename Type>
+	Type const &Persistent_tree<Type>::depth_iterator::operator*() const {
+		return stack.back().node->element;
+	}
+
+	/*
+	 * Increment
+	 *   depth_iterator &Persistent_tree<Type>::depth_iterator :: operator++()
+	 *
+	 * Pops the current node and pushes its children in
+	 * reverse order so that the first child is visited next.
+	 *
+	 * O(degree)
+	 */
+
+	template <typename Type>
+	typename Persistent_tree<Type>::depth_iterator &Persistent_tree<Type>::depth_iterator::operator++() {
+		persistent_node *node = stack.back().node;
+		int d = stack.back().position + 1;
+
+		stack.pop_back();
+
+		for ( std::size_t k = node->children.size(); k > 0; --k ) {
+			path_step step = { node->children[k - 1], d };
+			stack.push_back( step );
+		}
+
+		return *this;
+	}
+
+	template <typename Type>
+	typename Persistent_tree<Type>::depth_iterator Persistent_tree<Type>::depth_iterator::operator++( int ) {
+		depth_iterator copy = *this;
+		++( *this );
+
+		return copy;
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::depth_iterator::operator==( depth_iterator const &rhs ) const {
+		if ( stack.empty() || rhs.stack.empty() ) {
+			return stack.empty() && rhs.stack.empty();
+		}
+
+		return stack.back().node == rhs.stack.back().node;
+	}
+
+	template <typename Type>
+	bool Persistent_tree<Type>::depth_iterator::operator!=( depth_iterator const &rhs ) const {
+		return !( *this == rhs );
+	}
+}
+
+#endif
@@ -0,0 +1,289 @@
+#ifndef DATA_STRUCTURES_SCAN_VIEW
+#define DATA_STRUCTURES_SCAN_VIEW
+
+#include <algorithm>
+#include <cstddef>
+#include <stdint.h>
+#include <type_traits>
+#include <vector>
+
+#if defined( __AVX2__ ) || defined( __SSE4_2__ ) || defined( __SSE2__ )
+#include <immintrin.h>
+#endif
+
+#include "arvores-gerais.hpp"
+
+namespace Data_structures {
+	/****************************************************
+	 * ************************************************ *
+	 * *                Range Scanning                * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/*
+	 * Range Scan
+	 *   void scan_range( Type const *data, std::size_t n, Type const &lo, Type const &hi,
+	 *                    std::vector<std::size_t> &hits )
+	 *
+	 * Appends to hits, in increasing order, the position of each of
+	 * the n objects in the array data which is neither less than lo
+	 * nor greater than hi.
+	 *
+	 * For signed 32-bit integers, eight (AVX2) or four (SSE2)
+	 * objects, and for signed 64-bit integers, four (AVX2) or two
+	 * (SSE4.2) objects are compared with each instruction:  a lane
+	 * is a hit if neither lo > x nor x > hi, and the hits of a
+	 * vector are read from the bits of its mask.  The remaining
+	 * objects and all other types are compared one at a time.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Type>
+	void scan_range_scalar( Type const *data, std::size_t first, std::size_t n, Type const &lo, Type const &hi,
+	                        std::vector<std::size_t> &hits ) {
+		for ( std::size_t i = first; i < n; ++i ) {
+			if ( !( data[i] < lo ) && !( hi < data[i] ) ) {
+				hits.push_back( i );
+			}
+		}
+	}
+
+#if defined( __AVX2__ ) || defined( __SSE4_2__ ) || defined( __SSE2__ )
+	// Append the positions base + k of the set bits k of mask
+	inline void scan_mask( unsigned mask, std::size_t base, std::vector<std::size_t> &hits ) {
+		while ( mask != 0 ) {
+			hits.push_back( base + __builtin_ctz( mask ) );
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	inline void scan_range_int32( int32_t const *data, std::size_t n, int32_t lo, int32_t hi,
+	                              std::vector<std::size_t> &hits ) {
+		std::size_t i = 0;
+
+#if defined( __AVX2__ )
+		__m256i const low = _mm256_set1_epi32( lo );
+		__m256i const high = _mm256_set1_epi32( hi );
+
+		for ( ; i + 8 <= n; i += 8 ) {
+			__m256i x = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( data + i ) );
+			__m256i out = _mm256_or_si256( _mm256_cmpgt_epi32( low, x ), _mm256_cmpgt_epi32( x, high ) );
+			unsigned mask = ~_mm256_movemask_ps( _mm256_castsi256_ps( out ) ) & 0xFFu;
+
+			scan_mask( mask, i, hits );
+		}
+#elif defined( __SSE2__ )
+		__m128i const low = _mm_set1_epi32( lo );
+		__m128i const high = _mm_set1_epi32( hi );
+
+		for ( ; i + 4 <= n; i += 4 ) {
+			__m128i x = _mm_loadu_si128( reinterpret_cast<__m128i const *>( data + i ) );
+			__m128i out = _mm_or_si128( _mm_cmpgt_epi32( low, x ), _mm_cmpgt_epi32( x, high ) );
+			unsigned mask = ~_mm_movemask_ps( _mm_castsi128_ps( out ) ) & 0xFu;
+
+			scan_mask( mask, i, hits );
+		}
+#endif
+
+		scan_range_scalar( data, i, n, lo, hi, hits );
+	}
+
+	inline void scan_range_int64( int64_t const *data, std::size_t n, int64_t lo, int64_t hi,
+	                              std::vector<std::size_t> &hits ) {
+		std::size_t i = 0;
+
+#if defined( __AVX2__ )
+		__m256i const low = _mm256_set1_epi64x( lo );
+		__m256i const high = _mm256_set1_epi64x( hi );
+
+		for ( ; i + 4 <= n; i += 4 ) {
+			__m256i x = _mm256_loadu_si256( reinterpret_cast<__m256i const *>( data + i ) );
+			__m256i out = _mm256_or_si256( _mm256_cmpgt_epi64( low, x ), _mm256_cmpgt_epi64( x, high ) );
+			unsigned mask = ~_mm256_movemask_pd( _mm256_castsi256_pd( out ) ) & 0xFu;
+
+			scan_mask( mask, i, hits );
+		}
+#elif defined( __SSE4_2__ )
+		__m128i const low = _mm_set1_epi64x( lo );
+		__m128i const high = _mm_set1_epi64x( hi );
+
+		for ( ; i + 2 <= n; i += 2 ) {
+			__m128i x = _mm_loadu_si128( reinterpret_cast<__m128i const *>( data + i ) );
+			__m128i out = _mm_or_si128( _mm_cmpgt_epi64( low, x ), _mm_cmpgt_epi64( x, high ) );
+			unsigned mask = ~_mm_movemask_pd( _mm_castsi128_pd( out ) ) & 0x3u;
+
+			scan_mask( mask, i, hits );
+		}
+#endif
+
+		scan_range_scalar( data, i, n, lo, hi, hits );
+	}
+
+	// The lane width of a type which is scanned with vector
+	// instructions, or 0 if it is compared one at a time
+	template <typename Type>
+	struct scan_lanes:std::integral_constant<int,
+		( std::is_integral<Type>::value && std::is_signed<Type>::value &&
+		  ( sizeof( Type ) == 4 || sizeof( Type ) == 8 ) ) ? 8*sizeof( Type ) : 0> {
+	};
+
+	template <typename Type>
+	void scan_range( Type const *data, std::size_t n, Type const &lo, Type const &hi,
+	                 std::vector<std::size_t> &hits, std::integral_constant<int, 0> ) {
+		scan_range_scalar( data, 0, n, lo, hi, hits );
+	}
+
+	template <typename Type>
+	void scan_range( Type const *data, std::size_t n, Type const &lo, Type const &hi,
+	                 std::vector<std::size_t> &hits, std::integral_constant<int, 32> ) {
+		scan_range_int32( reinterpret_cast<int32_t const *>( data ), n, lo, hi, hits );
+	}
+
+	template <typename Type>
+	void scan_range( Type const *data, std::size_t n, Type const &lo, Type const &hi,
+	                 std::vector<std::size_t> &hits, std::integral_constant<int, 64> ) {
+		scan_range_int64( reinterpret_cast<int64_t const *>( data ), n, lo, hi, hits );
+	}
+
+	template <typename Type>
+	void scan_range( Type const *data, std::size_t n, Type const &lo, Type const &hi,
+	                 std::vector<std::size_t> &hits ) {
+		scan_range( data, n, lo, hi, hits, std::integral_constant<int, scan_lanes<Type>::value>() );
+	}
+
+	/****************************************************
+	 * ************************************************ *
+	 * *                  Scan View                   * *
+	 * ************************************************ *
+	 ****************************************************/
+
+	/****************************************************
+	 * Scan View Class
+	 *   class Scan_view<Tree>
+	 *
+	 * A frozen copy of the objects of a general tree stored
+	 * contiguously in pre-order, together with an iterator
+	 * referring to the node of each, for scans which find
+	 * all nodes storing an object in a range or equal to a
+	 * key.  The scans use vector instructions for signed
+	 * 32- and 64-bit integers (see scan_range).
+	 *
+	 * The view is not updated when the tree is modified:
+	 * refresh() copies the objects again.  Until then, the
+	 * scans report the objects as they were when copied and
+	 * the iterators of removed nodes are not valid.
+	 ****************************************************/
+
+	template <typename Tree>
+	class Scan_view {
+		public:
+			typedef typename Tree::iterator iterator;
+			typedef typename std::remove_reference<decltype( *std::declval<iterator &>() )>::type value_type;
+
+			explicit Scan_view( Tree & );
+
+			void refresh();
+			int size() const;
+
+			std::vector<iterator> find( value_type const &key ) const;
+			std::vector<iterator> find_range( value_type const &lo, value_type const &hi ) const;
+
+		private:
+			Tree *tree;
+			std::vector<value_type> elements;
+			std::vector<iterator> nodes;
+	};
+
+	/*
+	 * Constructor
+	 *   Scan_view<Tree> :: Scan_view( Tree &t )
+	 *
+	 * Creates a view of the tree with the objects copied.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Tree>
+	Scan_view<Tree>::Scan_view( Tree &t ):
+	tree( &t ),
+	elements(),
+	nodes() {
+		refresh();
+	}
+
+	/*
+	 * Refresh
+	 *   void Scan_view<Tree> :: refresh()
+	 *
+	 * Copies the objects and iterators of all nodes of the tree
+	 * in pre-order using a stack of explicit iterators, reusing
+	 * the memory of the previous copy.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Tree>
+	void Scan_view<Tree>::refresh() {
+		elements.clear();
+		nodes.clear();
+
+		std::vector<iterator> stack( 1, tree->begin() );
+
+		while ( !stack.empty() ) {
+			iterator itr = stack.back();
+			stack.pop_back();
+
+			elements.push_back( *itr );
+			nodes.push_back( itr );
+
+			std::size_t first = stack.size();
+
+			for ( iterator child = itr.begin(); child != itr.end(); ++child ) {
+				stack.push_back( child );
+			}
+
+			std::reverse( stack.begin() + first, stack.end() );
+		}
+	}
+
+	template <typename Tree>
+	int Scan_view<Tree>::size() const {
+		return static_cast<int>( elements.size() );
+	}
+
+	/*
+	 * Find
+	 *   std::vector<iterator> Scan_view<Tree> :: find( value_type const &key ) const
+	 *   std::vector<iterator> Scan_view<Tree> :: find_range( value_type const &lo, value_type const &hi ) const
+	 *
+	 * Return iterators referring to the nodes, in pre-order,
+	 * which store an object equal to the key or neither less
+	 * than lo nor greater than hi.
+	 *
+	 * O(n)
+	 */
+
+	template <typename Tree>
+	std::vector<typename Scan_view<Tree>::iterator> Scan_view<Tree>::find( value_type const &key ) const {
+		return find_range( key, key );
+	}
+
+	template <typename Tree>
+	std::vector<typename Scan_view<Tree>::iterator> Scan_view<Tree>::find_range( value_type const &lo, value_type const &hi ) const {
+		std::vector<std::size_t> hits;
+		scan_range( elements.data(), elements.size(), lo, hi, hits );
+
+		std::vector<iterator> result;
+		result.reserve( hits.size() );
+
+		for ( std::size_t k = 0; k < hits.size(); ++k ) {
+			result.push_back( nodes[hits[k]] );
+		}
+
+		return result;
+	}
+}
+
+#endif
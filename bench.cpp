@@ -0,0 +1,98 @@
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <chrono>
+using namespace std;
+
+/******************************************************
+ * This program measures the depth-first and the
+ * breadth-first traversals of large random and 8-ary
+ * trees with linked and with indexed children.
+ *
+ * "make bench" builds it once with the default
+ * GENERAL_TREE_PREFETCH_DISTANCE and once with 0 and
+ * runs both, so that the effect of the prefetch in the
+ * breadth-first iterator can be compared.  Each time is
+ * the best of nine traversals.
+ ******************************************************/
+
+#include "arvores-gerais.hpp"
+using namespace Data_structures;
+
+template <typename Function>
+double milliseconds( Function f ) {
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	f();
+
+	return chrono::duration<double, milli>( chrono::steady_clock::now() - start ).count();
+}
+
+/*
+ * Builds a tree of n nodes in which node i is a child of a
+ * random earlier node or, if fan is positive, of node
+ * ( i - 1 )/fan.  Blocks of random sizes are allocated
+ * between the nodes and then freed so that the nodes are
+ * scattered in memory as they are in a long-lived tree.
+ */
+
+template <typename Tree>
+void bench( char const *name, int n, int fan ) {
+	srand( 1 );
+
+	Tree tree( 0 );
+	vector<typename Tree::iterator> nodes;
+	vector<void *> gaps;
+	nodes.reserve( n );
+	nodes.push_back( tree.begin() );
+
+	for ( int i = 1; i < n; ++i ) {
+		int parent = ( fan > 0 ) ? ( i - 1 )/fan : rand() % i;
+
+		nodes[parent].insert( i );
+		nodes.push_back( nodes[parent].child( nodes[parent].degree() - 1 ) );
+		gaps.push_back( malloc( 48 + rand() % 64 ) );
+	}
+
+	for ( size_t i = 0; i < gaps.size(); ++i ) {
+		free( gaps[i] );
+	}
+
+	volatile long sink = 0;
+	double depth = 1e9, breadth = 1e9;
+
+	for ( int r = 0; r < 9; ++r ) {
+		depth = min( depth, milliseconds( [&]() {
+			long sum = 0;
+
+			for ( typename Tree::depth_iterator i = tree.begin_depth(); i != tree.end_depth(); ++i ) {
+				sum += *i;
+			}
+
+			sink = sum;
+		} ) );
+
+		breadth = min( breadth, milliseconds( [&]() {
+			long sum = 0;
+
+			for ( typename Tree::breadth_iterator i = tree.begin_breadth(); i != tree.end_breadth(); ++i ) {
+				sum += *i;
+			}
+
+			sink = sum;
+		} ) );
+	}
+
+	cout << name << "  prefetch " << GENERAL_TREE_PREFETCH_DISTANCE
+	     << "  depth-first " << depth << " ms  breadth-first " << breadth << " ms" << endl;
+}
+
+int main() {
+	int const n = 2000000;
+
+	bench<General_tree<int> >( "linked random ", n, 0 );
+	bench<General_tree<int> >( "linked 8-ary  ", n, 8 );
+	bench<General_tree<int, full_metadata, indexed_children<4> > >( "indexed random", n, 0 );
+	bench<General_tree<int, full_metadata, indexed_children<4> > >( "indexed 8-ary ", n, 8 );
+
+	return 0;
+}
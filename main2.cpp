@@ -4,9 +4,9 @@ using namespace std;
 
 /******************************************************
  * This function generates a randome tree and prints
- * the result using depth-first and breadth-first
- * traversals together with a user-defined pre-order
- * depth-first traversal.
+ * the result using depth-first, breadth-first and
+ * post-order traversals together with a user-defined
+ * pre-order depth-first traversal.
  ******************************************************/
 
 #include "arvores-gerais.hpp"
@@ -93,5 +93,15 @@ int main() {
 
 	cout << endl;
 
+	for (
+		General_tree<long>::postorder_iterator i = random_tree.begin_postorder();
+		i != random_tree.end_postorder();
+		++i
+	) {
+		cout << *i << " ";
+	}
+
+	cout << endl;
+
 	return 0;
 }
\ No newline at end of file